@@ -0,0 +1,174 @@
+#include "corpus_generator.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <fstream>
+#include <random>
+#include <utility>
+
+namespace {
+
+//Written first into every generated corpus; only directories holding it are ever deleted
+const char corpus_marker[] = ".tp_bench_corpus";
+
+const char *const color_java[] = {"black", "blue", "brown", "cyan", "gray", "green", "light_blue", "light_gray", "lime", "magenta", "orange", "pink", "purple", "red", "white", "yellow"};
+const char *const color_bedrock[] = {"black", "blue", "brown", "cyan", "gray", "green", "lightBlue", "silver", "lime", "magenta", "orange", "pink", "purple", "red", "white", "yellow"};
+
+//Java and Bedrock key families, like block.minecraft.X and tile.X.name
+const char *const families[][3] = {
+    {"block.minecraft.", "tile.", ".name"},
+    {"item.minecraft.", "item.", ".name"},
+    {"entity.minecraft.", "entity.", ".name"},
+    {"effect.minecraft.", "effect.", ""},
+    {"enchantment.minecraft.", "enchantment.", ""},
+    {"advancements.story.", "advancement.", ".title"},
+};
+
+//Words of each script; each language writes its values in one script
+const std::vector<std::vector<std::string>> scripts = {
+    {"stone", "oak", "planks", "copper", "block", "of", "the", "red", "ancient", "debris", "glass", "pane", "smooth", "chiseled"},
+    {"pierre", "chêne", "cuivré", "bloc", "ébène", "forêt", "déjà", "würfel", "kupferblöcke", "glänzend"},
+    {"камень", "дуб", "медный", "блок", "стекло", "древний", "гладкий"},
+    {"石", "オーク", "銅", "ブロック", "ガラス", "古代", "滑らかな", "木材"},
+    {"石头", "橡木", "铜块", "方块", "玻璃", "远古", "平滑", "雕纹"},
+};
+
+std::string makeWord(std::mt19937 &random,size_t index) {
+    static const char *const syllables[] = {"ka", "lo", "mi", "ne", "su", "ra", "to", "vi", "ze", "qu"};
+    std::string word;
+    for (size_t i = 0; i < 2 + random() % 3; i++) {
+        word += syllables[random() % 10];
+    }
+    return word + "_" + std::to_string(index);
+}
+
+std::string makeValue(std::mt19937 &random,const std::vector<std::string> &words,bool escaped) {
+    std::string value;
+    size_t word_count = 1 + random() % 4;
+    for (size_t i = 0; i < word_count; i++) {
+        if (!value.empty()) {
+            value += ' ';
+        }
+        value += words.at(random() % words.size());
+    }
+    if (escaped) {
+        value += random() % 2 == 0 ? " \\\"%s\\\"" : "\\n\\u00a7e%s";
+    }
+    return value;
+}
+
+//Key/value pair of one definition on both platforms
+struct Definition {
+    std::string java_key, bedrock_key;
+    bool escaped;
+};
+
+}
+
+bool generateCorpus(const std::string &directory,const CorpusOptions &options,CorpusSummary &summary) {
+
+    std::error_code error;
+    std::filesystem::create_directories(directory + "/lang_java", error);
+    std::filesystem::create_directories(directory + "/lang_bedrock", error);
+    if (error) {
+        return false;
+    }
+    std::ofstream(directory + "/" + corpus_marker) << "Generated by tp_bench; deleted with this directory when the next corpus is generated.\n";
+    std::mt19937 random(options.seed);
+
+    //Config files
+    std::ofstream config(directory + "/languages.txt");
+    for (int l = 0; l < options.languages; l++) {
+        std::string java_name = l == 0 ? "en_us" : "l" + std::to_string(l) + "_xx";
+        std::string bedrock_name = l == 0 ? "en_US" : "l" + std::to_string(l) + "_XX";
+        summary.java_language.push_back(java_name);
+        summary.bedrock_language.push_back(bedrock_name);
+        config << (l == 0 ? "" : "\n") << java_name << " " << bedrock_name;
+    }
+    config.close();
+    std::ofstream classic(directory + "/colors_classic.txt"), modern(directory + "/colors_new.txt");
+    for (int c = 0; c < 16; c++) {
+        classic << (c == 0 ? "" : "\n") << color_java[c] << " " << color_bedrock[c];
+        modern << (c == 0 ? "" : "\n") << color_java[c] << " " << color_java[c];
+    }
+    classic.close();
+    modern.close();
+    std::ofstream(directory + "/multiple.txt") << "example_java1 example_bedrock1\nexample_java2 example_bedrock2";
+
+    //Shared key set; the first keys are ported already, the rest only exist in Java
+    std::vector<Definition> definitions;
+    for (int k = 0; k < options.keys + options.new_keys; k++) {
+        const auto &family = families[random() % (sizeof(families) / sizeof(families[0]))];
+        std::string word = makeWord(random, k);
+        definitions.push_back({family[0] + word, family[1] + word + family[2], std::uniform_real_distribution<double>(0, 1)(random) < options.escape_fraction});
+    }
+    for (int c = 0; c < 16; c++) { //Java-only color set for a color port
+        definitions.push_back({std::string("block.minecraft.") + color_java[c] + "_bench_wool", std::string("tile.bench_wool.") + color_bedrock[c] + ".name", false});
+    }
+    for (int k = options.keys; k < options.keys + options.new_keys; k++) {
+        summary.new_java_keys.push_back(definitions.at(k).java_key);
+        summary.new_bedrock_keys.push_back(definitions.at(k).bedrock_key);
+    }
+    summary.color_java_base = "block.minecraft.VAR_bench_wool";
+    summary.color_bedrock_base = "tile.bench_wool.VAR.name";
+
+    //Bedrock files are grouped into sorted blocks, like the vanilla files
+    std::vector<std::pair<std::string, size_t>> bedrock_order;
+    for (int k = 0; k < options.keys; k++) {
+        bedrock_order.emplace_back(definitions.at(k).bedrock_key, k);
+    }
+    std::sort(bedrock_order.begin(), bedrock_order.end());
+
+    for (int l = 0; l < options.languages; l++) {
+        bool utf8 = l > 0 && std::uniform_real_distribution<double>(0, 1)(random) < options.utf8_fraction;
+        const std::vector<std::string> &words = scripts.at(utf8 ? 1 + random() % (scripts.size() - 1) : 0);
+
+        std::vector<std::string> values;
+        for (const auto &definition : definitions) {
+            values.push_back(makeValue(random, words, definition.escaped));
+        }
+
+        //Java file, in the extractor's two-space indented format
+        std::string json_text = "{\n";
+        for (size_t k = 0; k < definitions.size(); k++) {
+            json_text += "  \"" + definitions.at(k).java_key + "\": \"" + values.at(k) + "\"";
+            json_text += k + 1 < definitions.size() ? ",\n" : "\n";
+        }
+        json_text += "}";
+        std::ofstream(directory + "/lang_java/" + summary.java_language.at(l) + ".json", std::ios_base::binary) << json_text;
+        summary.java_bytes += json_text.size();
+
+        //Bedrock file with escapes resolved the simple way; only the shape matters here
+        std::string lang_text = "## Generated by tp_bench\n\n";
+        for (size_t b = 0; b < bedrock_order.size(); b++) {
+            if (b > 0 && b % options.block_size == 0) {
+                lang_text += "\n";
+            }
+            std::string value = values.at(bedrock_order.at(b).second);
+            value.erase(std::remove(value.begin(), value.end(), '\\'), value.end());
+            lang_text += bedrock_order.at(b).first + "=" + value + (l == 0 ? "\n" : "\t#\n");
+        }
+        std::ofstream(directory + "/lang_bedrock/" + summary.bedrock_language.at(l) + ".lang", std::ios_base::binary) << lang_text;
+        summary.bedrock_bytes += lang_text.size();
+    }
+
+    return true;
+}
+
+bool isGeneratedCorpus(const std::string &directory) {
+    std::error_code error;
+    return std::filesystem::is_regular_file(directory + "/" + corpus_marker, error);
+}
+
+bool removeGeneratedCorpus(const std::string &directory) {
+    std::error_code error;
+    if (!std::filesystem::exists(directory, error)) {
+        return true;
+    }
+    if (!isGeneratedCorpus(directory)) {
+        return false;
+    }
+    std::filesystem::remove_all(directory, error);
+    return !error;
+}
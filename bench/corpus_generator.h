@@ -0,0 +1,35 @@
+#ifndef TRANSLATION_PORTER_CORPUS_GENERATOR_H
+#define TRANSLATION_PORTER_CORPUS_GENERATOR_H
+
+#include <string>
+#include <vector>
+
+//Shape of a synthetic Minecraft-style corpus
+struct CorpusOptions {
+    int languages = 8;
+    int keys = 10000; //Definitions per language already ported to Bedrock
+    int new_keys = 200; //Definitions per language only in Java, available for porting
+    double utf8_fraction = 0.5; //Share of languages written in non-ASCII scripts
+    double escape_fraction = 0.05; //Share of Java values that contain JSON escapes
+    int block_size = 40; //Bedrock lines per blank-line separated block
+    unsigned seed = 1;
+};
+
+//What was generated, for building port jobs and reporting rates
+struct CorpusSummary {
+    std::vector<std::string> java_language, bedrock_language;
+    std::vector<std::string> new_java_keys, new_bedrock_keys; //Single-key ports that are missing from Bedrock
+    std::string color_java_base, color_bedrock_base; //VAR identifiers for a color port
+    size_t java_bytes = 0, bedrock_bytes = 0;
+};
+
+//Writes languages.txt, the color and multiple config files, lang_java/*.json and lang_bedrock/*.lang into directory
+bool generateCorpus(const std::string &directory,const CorpusOptions &options,CorpusSummary &summary);
+
+//True when directory holds the marker file generateCorpus writes
+bool isGeneratedCorpus(const std::string &directory);
+
+//Deletes directory if generateCorpus made it; a missing directory counts as removed, any other directory is left alone
+bool removeGeneratedCorpus(const std::string &directory);
+
+#endif
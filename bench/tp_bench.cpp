@@ -0,0 +1,229 @@
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "corpus_generator.h"
+#include "lang_tokenizer.h"
+#include "porter.h"
+
+//Time and work done by one phase of a port, summed over languages and iterations
+struct PhaseTotal {
+    const char *name;
+    double seconds = 0;
+    size_t bytes = 0;
+    size_t keys = 0;
+};
+
+int main(int argc, char* argv[]) {
+
+    //Benchmark settings
+    CorpusOptions corpus_options;
+    RunOptions run_options;
+    std::string directory = "tp_bench_corpus";
+    std::string tokenizer; //Instruction set for splitting .lang files; the widest available by default
+    int iterations = 1;
+    int ports = 50; //Single-key jobs per run, plus one color job
+    bool keep = false, generate_only = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        std::string value = i + 1 < argc ? argv[i + 1] : "";
+        bool used_value = true;
+        try {
+            if (argument == "--dir") directory = value;
+            else if (argument == "--languages") corpus_options.languages = std::stoi(value);
+            else if (argument == "--keys") corpus_options.keys = std::stoi(value);
+            else if (argument == "--new-keys") corpus_options.new_keys = std::stoi(value);
+            else if (argument == "--utf8") corpus_options.utf8_fraction = std::stod(value);
+            else if (argument == "--escapes") corpus_options.escape_fraction = std::stod(value);
+            else if (argument == "--block-size") corpus_options.block_size = std::stoi(value);
+            else if (argument == "--seed") corpus_options.seed = static_cast<unsigned>(std::stoul(value));
+            else if (argument == "--ports") ports = std::stoi(value);
+            else if (argument == "--iterations") iterations = std::stoi(value);
+            else if (argument == "--reader") run_options.java_reader = value;
+            else if (argument == "--placement") run_options.placement = value;
+            else if (argument == "--tokenizer") tokenizer = value;
+            else {
+                used_value = false;
+                if (argument == "--cache") run_options.use_cache = true;
+                else if (argument == "--keep") keep = true;
+                else if (argument == "--generate-only") generate_only = true;
+                else {
+                    std::cerr << "Usage: ./tp_bench [--dir <path>] [--languages N] [--keys N] [--new-keys N] [--utf8 F] [--escapes F] [--block-size N] [--seed N]" << std::endl;
+                    std::cerr << "                  [--ports N] [--iterations N] [--reader raw/sax/dom] [--placement block/key] [--tokenizer scalar/sse2/avx2] [--cache] [--keep] [--generate-only]" << std::endl;
+                    return -1;
+                }
+            }
+        }
+        catch (const std::exception &) {
+            std::cerr << "Invalid value for " << argument << "." << std::endl;
+            return -1;
+        }
+        if (used_value) {
+            i++;
+        }
+    }
+    if (run_options.java_reader != "raw" && run_options.java_reader != "sax" && run_options.java_reader != "dom") {
+        std::cerr << "Option --reader must be raw, sax or dom." << std::endl;
+        return -1;
+    }
+    if (run_options.placement != "block" && run_options.placement != "key") {
+        std::cerr << "Option --placement must be block or key." << std::endl;
+        return -1;
+    }
+    if (!tokenizer.empty() && !useLangTokenizer(tokenizer)) {
+        std::cerr << "Tokenizer " << tokenizer << " is not available on this processor." << std::endl;
+        return -1;
+    }
+    if (corpus_options.languages < 1 || corpus_options.keys < 1 || corpus_options.block_size < 1 || iterations < 1 || ports < 0 || ports > corpus_options.new_keys) {
+        std::cerr << "Scale settings must be positive, and --ports cannot exceed --new-keys." << std::endl;
+        return -1;
+    }
+
+    std::vector<PhaseTotal> phases = {{"config read"}, {"expansion"}, {"json load"}, {"lookup"}, {"bedrock scan"}, {"write"}};
+    std::filesystem::path start_directory = std::filesystem::current_path();
+    std::ostream discard(nullptr); //Port messages are not part of the measurement
+    std::streambuf *console = std::cout.rdbuf();
+    using clock = std::chrono::steady_clock;
+
+    //A previous corpus is replaced, but a directory the bench did not make is never deleted or written into
+    std::error_code error;
+    if (std::filesystem::exists(directory, error) && !isGeneratedCorpus(directory)
+        && (!std::filesystem::is_directory(directory, error) || !std::filesystem::is_empty(directory, error))) {
+        std::cerr << "Refusing to use " << directory << "; it is not an empty directory, and tp_bench did not generate it." << std::endl;
+        return -2;
+    }
+    if (!removeGeneratedCorpus(directory)) {
+        std::cerr << "Failed to remove the old corpus in " << directory << "." << std::endl;
+        return -2;
+    }
+    CorpusSummary summary;
+    if (!generateCorpus(directory, corpus_options, summary)) {
+        std::cerr << "Failed to generate corpus in " << directory << "." << std::endl;
+        return -2;
+    }
+    std::cout << "Generated " << summary.java_language.size() << " languages in " << directory << " ("
+              << summary.java_bytes / 1000000.0 << " MB Java, " << summary.bedrock_bytes / 1000000.0 << " MB Bedrock)." << std::endl << std::endl;
+    if (generate_only) {
+        return 0;
+    }
+
+    //A run modifies the Bedrock files, so each iteration starts from a copy of the originals
+    //Java files are left alone, so a cache compiled in the first iteration is reused by the rest
+    std::filesystem::current_path(directory);
+    std::filesystem::copy("lang_bedrock", "lang_bedrock_original");
+
+    for (int iteration = 0; iteration < iterations; iteration++) {
+
+        std::filesystem::copy("lang_bedrock_original", "lang_bedrock", std::filesystem::copy_options::overwrite_existing);
+        std::cout.rdbuf(nullptr);
+
+        //Config read
+        auto start = clock::now();
+        std::vector<std::string> java_language, bedrock_language;
+        int result = readConfigFile("languages.txt", java_language, bedrock_language);
+        phases.at(0).seconds += std::chrono::duration<double>(clock::now() - start).count();
+        phases.at(0).keys += java_language.size();
+
+        //Expansion
+        start = clock::now();
+        std::vector<PortJob> jobs(ports + 1);
+        for (int p = 0; p < ports && result == 0; p++) {
+            result = parseJob({"s", summary.new_java_keys.at(p), summary.new_bedrock_keys.at(p)}, jobs.at(p));
+        }
+        if (result == 0) {
+            result = parseJob({"c", summary.color_java_base, summary.color_bedrock_base}, jobs.back());
+        }
+        std::vector<std::string> en_us_keys;
+        for (auto & job : jobs) {
+            if (result == 0) {
+                result = expandJob(job, en_us_keys);
+            }
+        }
+        phases.at(1).seconds += std::chrono::duration<double>(clock::now() - start).count();
+        std::unordered_set<std::string> wanted_identifiers;
+        size_t job_keys = 0;
+        for (const auto & job : jobs) {
+            job_keys += job.java_identifier.size();
+            wanted_identifiers.insert(job.java_identifier.begin(), job.java_identifier.end());
+        }
+        phases.at(1).keys += job_keys;
+
+        for (size_t i = 0; i < java_language.size() && result == 0; i++) {
+
+            //JSON load
+            start = clock::now();
+            JavaValues java_values;
+            result = loadJavaValues(java_language.at(i), wanted_identifiers, run_options, java_values, discard, discard);
+            phases.at(2).seconds += std::chrono::duration<double>(clock::now() - start).count();
+            phases.at(2).bytes += std::filesystem::file_size("lang_java/" + java_language.at(i) + ".json");
+            phases.at(2).keys += corpus_options.keys + corpus_options.new_keys + 16;
+
+            //Lookup
+            start = clock::now();
+            std::vector<std::vector<std::string>> definitions;
+            if (result == 0) {
+                result = buildDefinitions(java_language.at(i), jobs, java_values, definitions, discard, discard);
+            }
+            phases.at(3).seconds += std::chrono::duration<double>(clock::now() - start).count();
+            phases.at(3).keys += job_keys;
+
+            //Bedrock scan and insertion
+            start = clock::now();
+            LangFile lang_file;
+            if (result == 0) {
+                result = readLangFile(bedrock_language.at(i), jobs, lang_file, discard, discard);
+            }
+            for (size_t j = 0; j < jobs.size() && result == 0; j++) {
+                result = insertDefinitions(lang_file, bedrock_language.at(i), jobs.at(j), definitions.at(j), run_options, discard);
+            }
+            phases.at(4).seconds += std::chrono::duration<double>(clock::now() - start).count();
+            phases.at(4).bytes += lang_file.mapping.size();
+            phases.at(4).keys += lang_file.lines.size();
+
+            //Write
+            start = clock::now();
+            size_t written_lines = lang_file.lines.size() + lang_file.added_lines.size();
+            if (result == 0) {
+                result = commitLangFile(bedrock_language.at(i), lang_file, discard, discard);
+            }
+            phases.at(5).seconds += std::chrono::duration<double>(clock::now() - start).count();
+            phases.at(5).bytes += std::filesystem::file_size("lang_bedrock/" + bedrock_language.at(i) + ".lang");
+            phases.at(5).keys += written_lines;
+        }
+        std::cout.rdbuf(console);
+        if (result != 0) {
+            std::cerr << "Port failed with code " << result << " during iteration " << iteration + 1 << "." << std::endl;
+            return result;
+        }
+    }
+
+    std::filesystem::current_path(start_directory);
+    if (!keep) {
+        removeGeneratedCorpus(directory);
+    }
+
+    //Report
+    std::cout << corpus_options.languages << " languages, " << corpus_options.keys << " keys, " << ports << " single ports + 1 color port, "
+              << iterations << " iteration(s), reader " << (run_options.use_cache ? "cache" : run_options.java_reader)
+              << ", tokenizer " << langTokenizerName() << std::endl << std::endl;
+    std::cout << std::left << std::setw(14) << "phase" << std::right << std::setw(12) << "ms" << std::setw(12) << "MB" << std::setw(12) << "MB/s" << std::setw(14) << "keys/s" << std::endl;
+    double total_seconds = 0;
+    for (const auto & phase : phases) {
+        total_seconds += phase.seconds;
+        double seconds = phase.seconds > 0 ? phase.seconds : 1e-9;
+        std::cout << std::left << std::setw(14) << phase.name << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(12) << phase.seconds * 1000 << std::setw(12) << phase.bytes / 1000000.0
+                  << std::setw(12) << (phase.bytes > 0 ? phase.bytes / 1000000.0 / seconds : 0.0)
+                  << std::setw(14) << std::setprecision(0) << phase.keys / seconds << std::endl;
+    }
+    std::cout << std::left << std::setw(14) << "total" << std::right << std::setw(12) << std::setprecision(2) << total_seconds * 1000 << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+#ifndef TRANSLATION_PORTER_BOUNDED_QUEUE_H
+#define TRANSLATION_PORTER_BOUNDED_QUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+//Queue between two pipeline stages; push waits while the queue is full, so a fast stage cannot run far ahead
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+    //Returns false without adding the item once the queue is closed
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        not_full.wait(lock, [&]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        not_empty.notify_one();
+        return true;
+    }
+
+    //Returns false once the queue is closed and every item has been taken
+    bool pop(T &item) {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        not_empty.wait(lock, [&]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    //Ends the queue; items already in it can still be taken
+    void close() {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    size_t capacity;
+    bool closed = false;
+    std::deque<T> items;
+    std::mutex queue_mutex;
+    std::condition_variable not_empty, not_full;
+};
+
+#endif
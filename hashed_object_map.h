@@ -0,0 +1,209 @@
+#ifndef TRANSLATION_PORTER_HASHED_OBJECT_MAP_H
+#define TRANSLATION_PORTER_HASHED_OBJECT_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+//Object type for nlohmann::basic_json, modeled on nlohmann::ordered_map: entries stay in insertion order in a vector,
+//and an open-addressing hash index finds them in one probe sequence instead of a tree walk of string compares
+//Every lookup takes a string_view, so finding a key never builds a key string
+template <class Key, class T, class IgnoredLess = std::less<Key>, class Allocator = std::allocator<std::pair<const Key, T>>>
+class HashedObjectMap {
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using Container = std::vector<value_type, Allocator>;
+    using iterator = typename Container::iterator;
+    using const_iterator = typename Container::const_iterator;
+    using size_type = typename Container::size_type;
+    using key_compare = std::equal_to<>;
+
+    HashedObjectMap() = default;
+    template <class It>
+    HashedObjectMap(It first,It last) { insert(first, last); }
+    HashedObjectMap(std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    iterator begin() { return entries.begin(); }
+    iterator end() { return entries.end(); }
+    const_iterator begin() const { return entries.begin(); }
+    const_iterator end() const { return entries.end(); }
+    const_iterator cbegin() const { return entries.cbegin(); }
+    const_iterator cend() const { return entries.cend(); }
+    size_type size() const { return entries.size(); }
+    size_type max_size() const { return entries.max_size(); }
+    bool empty() const { return entries.empty(); }
+
+    void clear() {
+        entries.clear();
+        slots.clear();
+    }
+
+    //Adds key unless it is already present; either way returns the entry for key
+    template <class KeyType>
+    std::pair<iterator, bool> emplace(KeyType &&key,T &&value) {
+        std::string_view key_view(key);
+        size_t hash = hashKey(key_view);
+        if ((entries.size() + 1) * 2 > slots.size()) { //Keep the index at most half full
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+        size_t slot = probe(key_view, hash);
+        if (slots[slot].entry != 0) {
+            return {entries.begin() + (slots[slot].entry - 1), false};
+        }
+        entries.emplace_back(std::forward<KeyType>(key), std::forward<T>(value));
+        slots[slot] = {static_cast<uint32_t>(entries.size()), static_cast<uint32_t>(hash)};
+        return {std::prev(entries.end()), true};
+    }
+
+    template <class KeyType>
+    T &operator[](KeyType &&key) {
+        return emplace(std::forward<KeyType>(key), T{}).first->second;
+    }
+
+    T &at(std::string_view key) {
+        iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("key not found");
+        }
+        return it->second;
+    }
+    const T &at(std::string_view key) const {
+        const_iterator it = find(key);
+        if (it == end()) {
+            throw std::out_of_range("key not found");
+        }
+        return it->second;
+    }
+
+    iterator find(std::string_view key) {
+        size_t entry = findEntry(key);
+        return entry == entries.size() ? end() : begin() + entry;
+    }
+    const_iterator find(std::string_view key) const {
+        size_t entry = findEntry(key);
+        return entry == entries.size() ? end() : begin() + entry;
+    }
+    size_type count(std::string_view key) const {
+        return findEntry(key) == entries.size() ? 0 : 1;
+    }
+
+    //Single probe find-and-read: the value for key, or nullptr when it is missing
+    const T *findValue(std::string_view key) const {
+        size_t entry = findEntry(key);
+        return entry == entries.size() ? nullptr : &entries[entry].second;
+    }
+
+    size_type erase(std::string_view key) {
+        iterator it = find(key);
+        if (it == end()) {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+    iterator erase(iterator pos) {
+        return erase(pos, std::next(pos));
+    }
+
+    //Entries have const keys and cannot be shifted in place, so the rest are rebuilt around the gap
+    iterator erase(iterator first,iterator last) {
+        size_t offset = first - begin(), erased = last - first;
+        Container kept(entries.get_allocator());
+        kept.reserve(entries.size() - erased);
+        for (size_t e = 0; e < entries.size(); e++) {
+            if (e < offset || e >= offset + erased) {
+                kept.emplace_back(std::move(entries[e]));
+            }
+        }
+        entries.swap(kept);
+        rehash(slots.size());
+        return begin() + offset;
+    }
+
+    std::pair<iterator, bool> insert(value_type &&value) {
+        return emplace(value.first, std::move(value.second));
+    }
+    std::pair<iterator, bool> insert(const value_type &value) {
+        return emplace(value.first, T(value.second));
+    }
+    template <class InputIt>
+    void insert(InputIt first,InputIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    friend bool operator==(const HashedObjectMap &a,const HashedObjectMap &b) {
+        if (a.size() != b.size()) {
+            return false;
+        }
+        for (const auto & entry : a) {
+            const T *other = b.findValue(entry.first);
+            if (other == nullptr || !(*other == entry.second)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend bool operator!=(const HashedObjectMap &a,const HashedObjectMap &b) {
+        return !(a == b);
+    }
+
+private:
+    //Index into entries plus one, so zero marks an empty slot; the stored hash skips most key compares
+    struct Slot {
+        uint32_t entry = 0;
+        uint32_t hash = 0;
+    };
+    using SlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Slot>;
+
+    static size_t hashKey(std::string_view key) {
+        return std::hash<std::string_view>()(key);
+    }
+
+    //Position of key in entries, or entries.size() when it is missing
+    size_t findEntry(std::string_view key) const {
+        if (slots.empty()) {
+            return entries.size();
+        }
+        size_t slot = probe(key, hashKey(key));
+        return slots[slot].entry == 0 ? entries.size() : slots[slot].entry - 1;
+    }
+
+    //Linear probing; returns the slot holding key, or the empty slot where it would go
+    size_t probe(std::string_view key,size_t hash) const {
+        size_t mask = slots.size() - 1;
+        for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot].entry == 0 || (slots[slot].hash == static_cast<uint32_t>(hash) && std::string_view(entries[slots[slot].entry - 1].first) == key)) {
+                return slot;
+            }
+        }
+    }
+
+    void rehash(size_t capacity) {
+        slots.assign(capacity, Slot());
+        size_t mask = capacity - 1;
+        for (size_t e = 0; e < entries.size(); e++) {
+            size_t hash = hashKey(entries[e].first);
+            size_t slot = hash & mask;
+            while (slots[slot].entry != 0) {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = {static_cast<uint32_t>(e + 1), static_cast<uint32_t>(hash)};
+        }
+    }
+
+    Container entries;
+    std::vector<Slot, SlotAllocator> slots; //Power of two in size, or empty
+};
+
+#endif
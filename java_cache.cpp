@@ -0,0 +1,144 @@
+#include "java_cache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace {
+
+const char cache_magic[8] = {'T', 'P', 'C', 'A', 'C', 'H', 'E', '1'};
+
+//Numbers the builds of this process, so threads building the same cache never share a temporary file
+std::atomic<unsigned long> build_count{0};
+
+//Identifies the source file a cache was built from
+struct CacheHeader {
+    char magic[8];
+    uint64_t entry_count;
+    uint64_t source_size;
+    int64_t source_time; //Last write time in file clock ticks
+    uint64_t source_hash;
+};
+
+}
+
+bool JavaCache::open(const std::string &cache_path,const std::string &source_path) {
+
+    entry_count = 0;
+    uint64_t source_size;
+    int64_t source_time;
+    if (!fileStatus(source_path, source_size, source_time) || !mapping.open(cache_path) || mapping.size() < sizeof(CacheHeader)) {
+        mapping.close();
+        return false;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, mapping.view().data(), sizeof(header));
+    if (std::memcmp(header.magic, cache_magic, sizeof(cache_magic)) != 0 || header.source_size != source_size
+        || header.entry_count > (mapping.size() - sizeof(CacheHeader)) / sizeof(Entry)) {
+        mapping.close();
+        return false;
+    }
+
+    //A touched but unchanged source is still valid
+    if (header.source_time != source_time) {
+        MappedFile source;
+        if (!source.open(source_path) || hashText(source.view()) != header.source_hash) {
+            mapping.close();
+            return false;
+        }
+    }
+
+    //Every key and value must lie inside the strings, so a damaged cache is rebuilt instead of read out of bounds
+    entry_count = header.entry_count;
+    strings_offset = sizeof(CacheHeader) + entry_count * sizeof(Entry);
+    uint64_t strings_size = mapping.size() - strings_offset;
+    for (size_t i = 0; i < entry_count; i++) {
+        Entry entry = entryAt(i);
+        if (static_cast<uint64_t>(entry.key_offset) + entry.key_size > strings_size || static_cast<uint64_t>(entry.value_offset) + entry.value_size > strings_size) {
+            entry_count = 0;
+            mapping.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+JavaCache::Entry JavaCache::entryAt(size_t index) const {
+    Entry entry;
+    std::memcpy(&entry, mapping.view().data() + sizeof(CacheHeader) + index * sizeof(Entry), sizeof(entry));
+    return entry;
+}
+
+std::optional<std::string_view> JavaCache::find(std::string_view key) const {
+
+    std::string_view strings = mapping.view().substr(strings_offset);
+    size_t low = 0, high = entry_count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        Entry entry = entryAt(middle);
+        int comparison = strings.substr(entry.key_offset, entry.key_size).compare(key);
+        if (comparison == 0) {
+            return strings.substr(entry.value_offset, entry.value_size);
+        }
+        if (comparison < 0) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return std::nullopt;
+}
+
+bool JavaCache::build(const std::string &cache_path,const std::string &source_path,std::vector<std::pair<std::string, std::string>> values) {
+
+    CacheHeader header {};
+    std::memcpy(header.magic, cache_magic, sizeof(cache_magic));
+    MappedFile source;
+    if (!fileStatus(source_path, header.source_size, header.source_time) || !source.open(source_path)) {
+        return false;
+    }
+    header.source_hash = hashText(source.view());
+    header.entry_count = values.size();
+
+    //Sorted by key for binary search
+    std::sort(values.begin(), values.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+
+    std::vector<Entry> entries;
+    entries.reserve(values.size());
+    size_t strings_size = 0;
+    for (const auto & [key, value] : values) {
+        if (strings_size + key.size() + value.size() > UINT32_MAX) {
+            return false;
+        }
+        Entry entry {};
+        entry.key_offset = static_cast<uint32_t>(strings_size);
+        entry.key_size = static_cast<uint32_t>(key.size());
+        entry.value_offset = static_cast<uint32_t>(strings_size + key.size());
+        entry.value_size = static_cast<uint32_t>(value.size());
+        entries.push_back(entry);
+        strings_size += key.size() + value.size();
+    }
+
+    std::vector<std::string_view> ranges;
+    ranges.emplace_back(reinterpret_cast<const char *>(&header), sizeof(header));
+    ranges.emplace_back(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+    for (const auto & [key, value] : values) {
+        ranges.emplace_back(key);
+        ranges.emplace_back(value);
+    }
+
+    //Written beside the cache and renamed, so a reader never maps a partial cache
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(cache_path).parent_path(), error);
+    std::string temp_path = cache_path + "." + std::to_string(currentProcessId()) + "." + std::to_string(build_count++) + ".tmp";
+    if (!writeFileRanges(temp_path, ranges) || !replaceFile(temp_path, cache_path)) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSLATION_PORTER_JAVA_CACHE_H
+#define TRANSLATION_PORTER_JAVA_CACHE_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "platform.h"
+
+//Compiled snapshot of one Java language file: a sorted key/value table that is mapped and binary searched
+//Layout: header, entry_count fixed-size entries sorted by key, then the key and value bytes
+class JavaCache {
+public:
+    //Maps cache_path if it was built from the current contents of source_path and every entry lies inside the file
+    bool open(const std::string &cache_path,const std::string &source_path);
+
+    //Finds a definition by binary search over the mapped table
+    std::optional<std::string_view> find(std::string_view key) const;
+
+    size_t size() const { return entry_count; }
+    size_t fileSize() const { return mapping.size(); }
+
+    //Writes a cache for source_path holding every definition in values
+    static bool build(const std::string &cache_path,const std::string &source_path,std::vector<std::pair<std::string, std::string>> values);
+
+private:
+    struct Entry {
+        uint32_t key_offset, key_size, value_offset, value_size;
+    };
+
+    Entry entryAt(size_t index) const;
+
+    MappedFile mapping;
+    size_t entry_count = 0;
+    size_t strings_offset = 0;
+};
+
+#endif
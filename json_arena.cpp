@@ -0,0 +1,40 @@
+#include "json_arena.h"
+
+#include <algorithm>
+
+thread_local MonotonicArena *ArenaScope::current_arena = nullptr;
+
+MonotonicArena::MonotonicArena(size_t first_block_size) : next_block_size(std::max<size_t>(first_block_size, 4096)) {}
+
+void *MonotonicArena::allocate(size_t bytes,size_t alignment) {
+
+    //Align within the current block, or start a block big enough for the request
+    size_t padding = (alignment - reinterpret_cast<uintptr_t>(position) % alignment) % alignment;
+    if (position == nullptr || static_cast<size_t>(block_end - position) < bytes + padding) {
+        size_t block_size = std::max(next_block_size, bytes + alignment);
+        blocks.emplace_back(new char[block_size]);
+        position = blocks.back().get();
+        block_end = position + block_size;
+        reserved_bytes += block_size;
+        next_block_size = block_size * 2; //Fewer, larger blocks as the document grows
+        padding = (alignment - reinterpret_cast<uintptr_t>(position) % alignment) % alignment;
+    }
+    void *allocation = position + padding;
+    position += padding + bytes;
+    return allocation;
+}
+
+ArenaScope::ArenaScope(MonotonicArena &arena) : previous(current_arena) {
+    current_arena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+    current_arena = previous;
+}
+
+MonotonicArena &ArenaScope::current() {
+    if (current_arena == nullptr) {
+        throw std::bad_alloc();
+    }
+    return *current_arena;
+}
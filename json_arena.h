@@ -0,0 +1,86 @@
+#ifndef TRANSLATION_PORTER_JSON_ARENA_H
+#define TRANSLATION_PORTER_JSON_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+#include "json.hpp"
+#include "hashed_object_map.h"
+
+//Bump allocator for one language's JSON document; nothing is freed until the whole arena is destroyed
+class MonotonicArena {
+public:
+    explicit MonotonicArena(size_t first_block_size = 1 << 20);
+    MonotonicArena(const MonotonicArena &) = delete;
+    MonotonicArena &operator=(const MonotonicArena &) = delete;
+
+    void *allocate(size_t bytes,size_t alignment);
+
+    //Bytes taken from the system, including unused space at the end of each block
+    size_t reserved() const { return reserved_bytes; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *position = nullptr, *block_end = nullptr;
+    size_t next_block_size, reserved_bytes = 0;
+};
+
+//Sends ArenaAllocator allocations on this thread to arena until the scope ends
+class ArenaScope {
+public:
+    explicit ArenaScope(MonotonicArena &arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope &) = delete;
+    ArenaScope &operator=(const ArenaScope &) = delete;
+
+    //Arena of the innermost scope on this thread; throws std::bad_alloc outside any scope
+    static MonotonicArena &current();
+
+private:
+    MonotonicArena *previous;
+    static thread_local MonotonicArena *current_arena;
+};
+
+//Stateless allocator over the current thread's arena, so containers need no allocator objects
+//Deallocation does nothing; memory returns to the system when the arena is destroyed
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &) {}
+
+    T *allocate(size_t count) {
+        return static_cast<T *>(ArenaScope::current().allocate(count * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *,size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &) const { return false; }
+};
+
+using arena_string = std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>>;
+
+//JSON document whose strings, arrays and objects all live in the current arena, with hashed objects
+using arena_json = nlohmann::basic_json<HashedObjectMap, std::vector, arena_string, bool, std::int64_t, std::uint64_t, double, ArenaAllocator>;
+
+//Parses text into a document allocated in arena; it is never destroyed, only released with the arena
+//Returns nullptr when text is not valid JSON
+template <typename Iterator>
+arena_json *parseArenaJson(MonotonicArena &arena,Iterator first,Iterator last) {
+    ArenaScope scope(arena);
+    arena_json document = arena_json::parse(first, last, nullptr, false);
+    if (document.is_discarded()) {
+        return nullptr;
+    }
+    return new (arena.allocate(sizeof(arena_json), alignof(arena_json))) arena_json(std::move(document));
+}
+
+#endif
@@ -0,0 +1,390 @@
+#include "json_scanner.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+//Position in the text being scanned; every scan function returns false on invalid JSON
+struct JsonCursor {
+    const char *position;
+    const char *end;
+};
+
+void skipWhitespace(JsonCursor &cursor) {
+    while (cursor.position != cursor.end && (*cursor.position == ' ' || *cursor.position == '\n' || *cursor.position == '\r' || *cursor.position == '\t')) {
+        cursor.position++;
+    }
+}
+
+int hexValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    return -1;
+}
+
+//Reads the four hex digits of a \u escape
+bool readHex4(const char *position,const char *end,uint32_t &code) {
+    if (end - position < 4) {
+        return false;
+    }
+    code = 0;
+    for (int i = 0; i < 4; i++) {
+        int digit = hexValue(position[i]);
+        if (digit < 0) {
+            return false;
+        }
+        code = code << 4 | static_cast<uint32_t>(digit);
+    }
+    return true;
+}
+
+//Steps over one multi-byte UTF-8 character, accepting the same byte ranges as the json.hpp parser
+bool skipUtf8(JsonCursor &cursor) {
+    unsigned char lead = static_cast<unsigned char>(*cursor.position);
+    size_t continuation;
+    unsigned char low = 0x80, high = 0xBF; //Range of the first continuation byte
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        continuation = 1;
+    }
+    else if (lead >= 0xE0 && lead <= 0xEF) {
+        continuation = 2;
+        low = lead == 0xE0 ? 0xA0 : 0x80; //No overlong forms
+        high = lead == 0xED ? 0x9F : 0xBF; //No surrogates
+    }
+    else if (lead >= 0xF0 && lead <= 0xF4) {
+        continuation = 3;
+        low = lead == 0xF0 ? 0x90 : 0x80;
+        high = lead == 0xF4 ? 0x8F : 0xBF; //Nothing past U+10FFFF
+    }
+    else {
+        return false;
+    }
+    if (static_cast<size_t>(cursor.end - cursor.position) <= continuation) {
+        return false;
+    }
+    for (size_t i = 1; i <= continuation; i++) {
+        unsigned char c = static_cast<unsigned char>(cursor.position[i]);
+        if (c < (i == 1 ? low : 0x80) || c > (i == 1 ? high : 0xBF)) {
+            return false;
+        }
+    }
+    cursor.position += continuation + 1;
+    return true;
+}
+
+//Scans a string from just after its opening quote to just after its closing quote
+//contents is the raw text between the quotes, and escaped tells whether it holds any escape
+bool scanString(JsonCursor &cursor,std::string_view &contents,bool &escaped) {
+    const char *start = cursor.position;
+    escaped = false;
+    while (cursor.position != cursor.end) {
+        unsigned char c = static_cast<unsigned char>(*cursor.position);
+        if (c == '"') {
+            contents = std::string_view(start, cursor.position - start);
+            cursor.position++;
+            return true;
+        }
+        if (c == '\\') {
+            escaped = true;
+            cursor.position++;
+            if (cursor.position == cursor.end) {
+                return false;
+            }
+            char escape = *cursor.position;
+            if (escape == '"' || escape == '\\' || escape == '/' || escape == 'b' || escape == 'f' || escape == 'n' || escape == 'r' || escape == 't') {
+                cursor.position++;
+                continue;
+            }
+            uint32_t code, low_code;
+            if (escape != 'u' || !readHex4(cursor.position + 1, cursor.end, code)) {
+                return false;
+            }
+            cursor.position += 5;
+            if (code >= 0xDC00 && code <= 0xDFFF) { //Low surrogate without a high one
+                return false;
+            }
+            if (code >= 0xD800 && code <= 0xDBFF) { //High surrogate must be followed by a low one
+                if (cursor.end - cursor.position < 2 || cursor.position[0] != '\\' || cursor.position[1] != 'u' || !readHex4(cursor.position + 2, cursor.end, low_code) || low_code < 0xDC00 || low_code > 0xDFFF) {
+                    return false;
+                }
+                cursor.position += 6;
+            }
+        }
+        else if (c < 0x20) { //Control characters must be escaped
+            return false;
+        }
+        else if (c < 0x80) {
+            cursor.position++;
+        }
+        else if (!skipUtf8(cursor)) {
+            return false;
+        }
+    }
+    return false;
+}
+
+bool skipDigits(JsonCursor &cursor) {
+    const char *start = cursor.position;
+    while (cursor.position != cursor.end && *cursor.position >= '0' && *cursor.position <= '9') {
+        cursor.position++;
+    }
+    return cursor.position != start;
+}
+
+//-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool scanNumber(JsonCursor &cursor) {
+    const char *start = cursor.position;
+    if (*cursor.position == '-') {
+        cursor.position++;
+    }
+    if (cursor.position != cursor.end && *cursor.position == '0') {
+        cursor.position++;
+    }
+    else if (!skipDigits(cursor)) {
+        return false;
+    }
+    if (cursor.position != cursor.end && *cursor.position == '.') {
+        cursor.position++;
+        if (!skipDigits(cursor)) {
+            return false;
+        }
+    }
+    if (cursor.position != cursor.end && (*cursor.position == 'e' || *cursor.position == 'E')) {
+        cursor.position++;
+        if (cursor.position != cursor.end && (*cursor.position == '+' || *cursor.position == '-')) {
+            cursor.position++;
+        }
+        if (!skipDigits(cursor)) {
+            return false;
+        }
+    }
+
+    //json.hpp rejects numbers too large for a double
+    return std::isfinite(std::strtod(std::string(start, cursor.position).c_str(), nullptr));
+}
+
+bool scanLiteral(JsonCursor &cursor,std::string_view literal) {
+    if (static_cast<size_t>(cursor.end - cursor.position) < literal.size() || std::string_view(cursor.position, literal.size()) != literal) {
+        return false;
+    }
+    cursor.position += literal.size();
+    return true;
+}
+
+//Scans an object member's key and the colon after it
+bool scanMemberKey(JsonCursor &cursor,std::string_view &key,bool &escaped) {
+    skipWhitespace(cursor);
+    if (cursor.position == cursor.end || *cursor.position != '"') {
+        return false;
+    }
+    cursor.position++;
+    if (!scanString(cursor, key, escaped)) {
+        return false;
+    }
+    skipWhitespace(cursor);
+    if (cursor.position == cursor.end || *cursor.position != ':') {
+        return false;
+    }
+    cursor.position++;
+    return true;
+}
+
+//Checks and steps over one value of any type; nesting is tracked on a stack, so deep input cannot overflow the call stack
+bool skipValue(JsonCursor &cursor) {
+    std::vector<char> closers; //Closing bracket of each container the value is inside
+    std::string_view key;
+    bool escaped;
+    while (true) {
+        skipWhitespace(cursor);
+        if (cursor.position == cursor.end) {
+            return false;
+        }
+        char c = *cursor.position;
+        if (c == '{' || c == '[') {
+            char closer = c == '{' ? '}' : ']';
+            cursor.position++;
+            skipWhitespace(cursor);
+            if (cursor.position == cursor.end || *cursor.position != closer) {
+                closers.push_back(closer);
+                if (closer == '}' && !scanMemberKey(cursor, key, escaped)) {
+                    return false;
+                }
+                continue; //First member or element
+            }
+            cursor.position++; //Empty container
+        }
+        else if (c == '"') {
+            cursor.position++;
+            if (!scanString(cursor, key, escaped)) {
+                return false;
+            }
+        }
+        else if (c == '-' || (c >= '0' && c <= '9')) {
+            if (!scanNumber(cursor)) {
+                return false;
+            }
+        }
+        else if (!scanLiteral(cursor, "true") && !scanLiteral(cursor, "false") && !scanLiteral(cursor, "null")) {
+            return false;
+        }
+
+        //A value ended; close finished containers until the next member or element
+        while (true) {
+            if (closers.empty()) {
+                return true;
+            }
+            skipWhitespace(cursor);
+            if (cursor.position == cursor.end) {
+                return false;
+            }
+            if (*cursor.position == ',') {
+                cursor.position++;
+                if (closers.back() == '}' && !scanMemberKey(cursor, key, escaped)) {
+                    return false;
+                }
+                break;
+            }
+            if (*cursor.position != closers.back()) {
+                return false;
+            }
+            cursor.position++;
+            closers.pop_back();
+        }
+    }
+}
+
+void appendUtf8(uint32_t code,std::string &output) {
+    if (code < 0x80) {
+        output += static_cast<char>(code);
+    }
+    else if (code < 0x800) {
+        output += static_cast<char>(0xC0 | code >> 6);
+        output += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000) {
+        output += static_cast<char>(0xE0 | code >> 12);
+        output += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else {
+        output += static_cast<char>(0xF0 | code >> 18);
+        output += static_cast<char>(0x80 | (code >> 12 & 0x3F));
+        output += static_cast<char>(0x80 | (code >> 6 & 0x3F));
+        output += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+}
+
+bool scanJsonStrings(std::string_view text,const std::function<bool(std::string_view,std::string_view,bool)> &on_string,const std::function<bool(std::string_view)> &on_other) {
+    JsonCursor cursor{text.data(), text.data() + text.size()};
+    if (text.substr(0, 3) == "\xEF\xBB\xBF") { //Byte order mark, skipped as json.hpp does
+        cursor.position += 3;
+    }
+    skipWhitespace(cursor);
+
+    //Anything but an object has no definitions, but must still be valid
+    if (cursor.position == cursor.end || *cursor.position != '{') {
+        if (!skipValue(cursor)) {
+            return false;
+        }
+        skipWhitespace(cursor);
+        return cursor.position == cursor.end;
+    }
+    cursor.position++;
+    skipWhitespace(cursor);
+    if (cursor.position != cursor.end && *cursor.position == '}') {
+        cursor.position++;
+    }
+    else {
+        std::string unescaped_key;
+        std::string_view key, value;
+        bool key_escaped, value_escaped;
+        while (true) {
+            if (!scanMemberKey(cursor, key, key_escaped)) {
+                return false;
+            }
+            if (key_escaped) {
+                unescaped_key.clear();
+                appendUnescaped(key, unescaped_key);
+                key = unescaped_key;
+            }
+            skipWhitespace(cursor);
+            if (cursor.position != cursor.end && *cursor.position == '"') {
+                cursor.position++;
+                if (!scanString(cursor, value, value_escaped)) {
+                    return false;
+                }
+                if (!on_string(key, value, value_escaped)) {
+                    return true;
+                }
+            }
+            else {
+                if (!skipValue(cursor)) {
+                    return false;
+                }
+                if (on_other && !on_other(key)) {
+                    return true;
+                }
+            }
+            skipWhitespace(cursor);
+            if (cursor.position == cursor.end) {
+                return false;
+            }
+            if (*cursor.position == '}') {
+                cursor.position++;
+                break;
+            }
+            if (*cursor.position != ',') {
+                return false;
+            }
+            cursor.position++;
+        }
+    }
+    skipWhitespace(cursor);
+    return cursor.position == cursor.end;
+}
+
+void appendUnescaped(std::string_view raw_value,std::string &output) {
+    size_t position = 0;
+    while (position < raw_value.size()) {
+        size_t backslash = raw_value.find('\\', position);
+        if (backslash == std::string_view::npos) {
+            output.append(raw_value.data() + position, raw_value.size() - position);
+            return;
+        }
+        output.append(raw_value.data() + position, backslash - position);
+        char escape = raw_value[backslash + 1];
+        position = backslash + 2;
+        switch (escape) {
+            case 'b': output += '\b'; break;
+            case 'f': output += '\f'; break;
+            case 'n': output += '\n'; break;
+            case 'r': output += '\r'; break;
+            case 't': output += '\t'; break;
+            case 'u': {
+                uint32_t code = 0, low_code = 0;
+                readHex4(raw_value.data() + position, raw_value.data() + raw_value.size(), code);
+                position += 4;
+                if (code >= 0xD800 && code <= 0xDBFF) { //Checked while scanning to be followed by a low surrogate
+                    readHex4(raw_value.data() + position + 2, raw_value.data() + raw_value.size(), low_code);
+                    code = 0x10000 + ((code - 0xD800) << 10) + (low_code - 0xDC00);
+                    position += 6;
+                }
+                appendUtf8(code, output);
+                break;
+            }
+            default: output += escape; break; //Quote, backslash or slash
+        }
+    }
+}
@@ -0,0 +1,18 @@
+#ifndef TRANSLATION_PORTER_JSON_SCANNER_H
+#define TRANSLATION_PORTER_JSON_SCANNER_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+//Calls on_string for each member of the top-level object whose value is a string, in file order
+//The key is already unescaped; the value is the raw text between its quotes, still escaped when escaped is set
+//on_other, when given, is called with the key of each member whose value is anything else
+//Either returns false to stop early, which is not an error; nothing after that point is checked
+//Returns false when text is not valid JSON up to where scanning stopped
+bool scanJsonStrings(std::string_view text,const std::function<bool(std::string_view,std::string_view,bool)> &on_string,const std::function<bool(std::string_view)> &on_other = nullptr);
+
+//Appends the unescaped contents of a string value that scanJsonStrings has already checked
+void appendUnescaped(std::string_view raw_value,std::string &output);
+
+#endif
@@ -0,0 +1,180 @@
+#include "lang_tokenizer.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define TP_TOKENIZER_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define TP_TARGET_AVX2
+#else
+#define TP_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+//Line being split: where it starts, and its first '=' once one is seen
+struct LineState {
+    size_t begin = 0;
+    size_t equals = std::string_view::npos;
+};
+
+inline void endLine(LineState &line,size_t newline,std::vector<LangToken> &tokens) {
+    size_t key_end = line.equals == std::string_view::npos ? newline : line.equals;
+    tokens.push_back({line.begin, key_end - line.begin, newline - line.begin});
+    line.begin = newline + 1;
+    line.equals = std::string_view::npos;
+}
+
+//Splits [begin, end) of text with memchr, continuing the line already in progress
+void tokenizeRange(const char *text,size_t begin,size_t end,LineState &line,std::vector<LangToken> &tokens) {
+    while (begin < end) {
+        const char *newline = static_cast<const char *>(std::memchr(text + begin, '\n', end - begin));
+        size_t stop = newline != nullptr ? newline - text : end;
+        if (line.equals == std::string_view::npos) {
+            const char *equals = static_cast<const char *>(std::memchr(text + begin, '=', stop - begin));
+            if (equals != nullptr) {
+                line.equals = equals - text;
+            }
+        }
+        if (newline == nullptr) {
+            return;
+        }
+        endLine(line, stop, tokens);
+        begin = stop + 1;
+    }
+}
+
+void tokenizeScalar(std::string_view text,std::vector<LangToken> &tokens) {
+    LineState line;
+    tokenizeRange(text.data(), 0, text.size(), line, tokens);
+    endLine(line, text.size(), tokens);
+}
+
+#ifdef TP_TOKENIZER_X86
+
+inline unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanForward(&bit, mask);
+    return bit;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+//Handles the newlines and '=' of one block starting at base, in order; each bit of a mask is one byte
+inline void addMatches(uint32_t newlines,uint32_t equals,size_t base,LineState &line,std::vector<LangToken> &tokens) {
+    uint32_t matches = newlines | equals;
+    while (matches != 0) {
+        uint32_t bit = matches & (0u - matches);
+        size_t offset = base + lowestBit(matches);
+        if ((newlines & bit) != 0) {
+            endLine(line, offset, tokens);
+        }
+        else if (line.equals == std::string_view::npos) {
+            line.equals = offset;
+        }
+        matches ^= bit;
+    }
+}
+
+void tokenizeSse2(std::string_view text,std::vector<LangToken> &tokens) {
+    const char *data = text.data();
+    const __m128i newline = _mm_set1_epi8('\n'), equals = _mm_set1_epi8('=');
+    LineState line;
+    size_t i = 0;
+    for (; i + 16 <= text.size(); i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        uint32_t newline_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)));
+        uint32_t equals_mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, equals)));
+        if ((newline_mask | equals_mask) != 0) {
+            addMatches(newline_mask, equals_mask, i, line, tokens);
+        }
+    }
+    tokenizeRange(data, i, text.size(), line, tokens);
+    endLine(line, text.size(), tokens);
+}
+
+TP_TARGET_AVX2 void tokenizeAvx2(std::string_view text,std::vector<LangToken> &tokens) {
+    const char *data = text.data();
+    const __m256i newline = _mm256_set1_epi8('\n'), equals = _mm256_set1_epi8('=');
+    LineState line;
+    size_t i = 0;
+    for (; i + 32 <= text.size(); i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        uint32_t newline_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline)));
+        uint32_t equals_mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, equals)));
+        if ((newline_mask | equals_mask) != 0) {
+            addMatches(newline_mask, equals_mask, i, line, tokens);
+        }
+    }
+    tokenizeRange(data, i, text.size(), line, tokens);
+    endLine(line, text.size(), tokens);
+}
+
+bool hasAvx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 6) == 6; //OSXSAVE, and the OS saves YMM registers
+    __cpuidex(info, 7, 0);
+    return os_saves_avx && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif
+
+struct TokenizerChoice {
+    void (*tokenize)(std::string_view,std::vector<LangToken>&);
+    const char *name;
+};
+
+//Picks the widest instruction set once, the first time a file is split; useLangTokenizer can replace it
+TokenizerChoice &chosenTokenizer() {
+    static TokenizerChoice choice = []() -> TokenizerChoice {
+#ifdef TP_TOKENIZER_X86
+        if (hasAvx2()) {
+            return {tokenizeAvx2, "avx2"};
+        }
+        return {tokenizeSse2, "sse2"}; //Every x86-64 processor has SSE2
+#else
+        return {tokenizeScalar, "scalar"};
+#endif
+    }();
+    return choice;
+}
+
+}
+
+void tokenizeLang(std::string_view text,std::vector<LangToken> &tokens) {
+    tokens.clear();
+    tokens.reserve(text.size() / 32 + 1); //Typical line length, to skip most regrowth
+    chosenTokenizer().tokenize(text, tokens);
+}
+
+const char *langTokenizerName() {
+    return chosenTokenizer().name;
+}
+
+bool useLangTokenizer(const std::string &name) {
+    TokenizerChoice choice = {tokenizeScalar, "scalar"};
+#ifdef TP_TOKENIZER_X86
+    if (name == "sse2") {
+        choice = {tokenizeSse2, "sse2"};
+    }
+    else if (name == "avx2" && hasAvx2()) {
+        choice = {tokenizeAvx2, "avx2"};
+    }
+#endif
+    if (name != choice.name) {
+        return false;
+    }
+    chosenTokenizer() = choice;
+    return true;
+}
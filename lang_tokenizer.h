@@ -0,0 +1,31 @@
+#ifndef TRANSLATION_PORTER_LANG_TOKENIZER_H
+#define TRANSLATION_PORTER_LANG_TOKENIZER_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//One line of a .lang file as offsets into its text, without the '\n'
+//The key is the text before the first '=', or the whole line when it has none; the value is the rest after the '='
+struct LangToken {
+    size_t begin = 0;
+    size_t key_size = 0;
+    size_t size = 0;
+
+    bool hasValue() const { return key_size < size; }
+};
+
+//Splits text into lines in one pass, finding each '\n' and each line's first '=' together
+//Lines are split as getline would: the last token is empty when text ends with a newline
+//Uses AVX2 or SSE2 when the processor has them, and plain loops elsewhere
+void tokenizeLang(std::string_view text,std::vector<LangToken> &tokens);
+
+//Instruction set tokenizeLang uses on this processor: "avx2", "sse2" or "scalar"
+const char *langTokenizerName();
+
+//Makes tokenizeLang use the named instruction set instead, for comparing them; false when this processor lacks it
+//Call before any file is split, since the choice is shared by every thread
+bool useLangTokenizer(const std::string &name);
+
+#endif
@@ -1,129 +1,110 @@
 #include <string>
 #include <iostream>
-#include <fstream>
-#include <Windows.h>
 #include <cstdio>
 #include <vector>
-#include "json.hpp"
-using json = nlohmann::json;
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
+#include <memory>
+#include "porter.h"
+#include "profiler.h"
 
-int readConfigFile(const std::string& input_filename,std::vector<std::string> &java_vector,std::vector<std::string> &bedrock_vector);
-int expandIdentifier(std::string base_identifier,std::vector<std::string> &identifier_list,const std::vector<std::string> &expansion_list);
+int parseOptions(int argc,char* argv[],RunOptions &options,std::vector<std::string> &arguments,std::unordered_set<std::string> &given_options);
 
 int main(int argc, char* argv[]) {
 
     //UTF-8 Setup
-
-    // Set console code page to UTF-8 so console known how to interpret string data
-    SetConsoleOutputCP(CP_UTF8);
-
-    // Enable buffering to prevent VS from chopping up UTF-8 byte sequences
-    setvbuf(stdout, nullptr, _IOFBF, 1000);
+    setupConsole();
 
 //////
 //////  INPUT PROCESSING
 //////
 
-    //Validate input arguments
-    //<program.exe> <s/m/c/n> <java_identifier> <bedrock_identifier> <prefix> <suffix>
-    // s/m/c/n == single/multiple/classic_color/new_color
-    // VAR converts to the multiple definitions or the colors in identifiers
-    // SECTION converts to § in prefix and suffix
-    // NULL indicates to exclude that argument, for the optional args
-    if (argc < 4) {
-        std::cerr << "Usage: (required) ./translation_translator <s/m/c/n> <base_java_identifier> <base_bedrock_identifier> (optional) <prefix> <suffix> <sort_override>" << std::endl;
+    //Run options may appear anywhere in the arguments; everything else is positional
+    RunOptions options;
+    std::vector<std::string> arguments;
+    std::unordered_set<std::string> given_options;
+    if (parseOptions(argc, argv, options, arguments, given_options) != 0) {
         return -1;
     }
-    std::cout << "User-Defined Configuration: " << std::endl;
-
-    //Expansion type
-    char expansion_type = *argv[1];
-    if (expansion_type == 's') {
-        std::cout << "Expansion Type: Single" << std::endl;
+    std::unique_ptr<Profiler> profiler;
+    if (options.profile) {
+        profiler = std::make_unique<Profiler>();
     }
-    else if (expansion_type == 'm') {
-        std::cout << "Expansion Type: Multiple; reads from \"multiple.txt\"." << std::endl;
-    }
-    else if (expansion_type == 'c') {
-        std::cout << "Expansion Type: 16 Colors (Original Names); reads from \"colors_classic.txt\"." << std::endl;
+    Profiler::Phase input_phase(profiler.get(), "", "input");
+
+    //Validate input arguments
+    //<program.exe> <s/m/c/n/p> <java_identifier> <bedrock_identifier> <prefix> <suffix> <sort_override>
+    //<program.exe> b <job_file>
+    //<program.exe> d <old_java_folder> <key_map_file>
+    //<program.exe> a <key_map_file>
+    // s/m/c/n/p == single/multiple/classic_color/new_color/pattern
+    // b == batch, one <s/m/c/n/p> line per job in the job file
+    // d == release diff, every en_us definition added or changed since the Java files in old_java_folder, renamed through the key map
+    // a == analysis, writes Java and Bedrock identifiers with the same English definition to the key map file, without porting
+    // --jobs N == port N languages at once
+    // --reader raw/sax/dom == how Java files are parsed
+    // --placement block/key == insert each job's lines together, or each line at its own sorted position
+    // --on-conflict duplicate/replace/skip/error == what to do when a key is already defined
+    // --sync == flush all written files to disk at the end
+    // --pipeline == prefetch the next language's files while merging one and writing another
+    // --cache == read Java definitions from compiled snapshots in .cache
+    // --incremental == skip languages whose files and jobs are unchanged since their last port
+    // --profile(=file.json) == print time, bytes and memory of each phase, optionally also as JSON
+    std::vector<PortJob> jobs;
+    if ((arguments.size() == 2 || arguments.size() == 3) && arguments.at(0) == "a") { //The Java folder defaults to lang_java
+        return deriveKeyMap((arguments.size() == 3 ? arguments.at(2) : std::string("lang_java")) + "/en_us.json", "lang_bedrock/en_US.lang", arguments.at(1));
     }
-    else if (expansion_type == 'n') {
-        std::cout << "Expansion Type: 16 Colors (New Names); reads from \"colors_new.txt\"." << std::endl;
+    if (arguments.size() == 2 && arguments.at(0) == "b") {
+        if (readJobFile(arguments.at(1), jobs) != 0) {
+            std::cerr << "Aborted. Failed to read " << arguments.at(1) << "." << std::endl;
+            return -11;
+        }
     }
-    else {
-        std::cerr << "Expansion type not recognized. Valid characters are s (single), m (multiple), c (classic color), or n (new color)." << std::endl;
-        return -10;
+    else if (arguments.size() == 2 && arguments.at(0) == "d") {
+        std::cerr << "Release diff needs a key map file, since Java and Bedrock identifiers differ; write one with: ./translation_translator a <key_map_file>" << std::endl;
+        return -1;
     }
-
-    //Java identifier
-    std::string base_java_identifier = argv[2]; //Used to construct real identifiers
-    std::cout << "Base Java Identifier: " << base_java_identifier << std::endl;
-
-    //Bedrock identifier
-    std::string base_bedrock_identifier = argv[3]; //Used to construct real identifiers
-    std::cout << "Base Bedrock Identifier: " << base_bedrock_identifier << std::endl;
-
-    //Prefix
-    std::string prefix;
-    if (argc > 4) {
-        prefix = argv[4];
-        size_t section_location = prefix.find("SECTION");
-        if (prefix == "NULL") {
-            prefix = "";
+    else if (arguments.size() == 3 && arguments.at(0) == "d") {
+        if (given_options.count("--placement") != 0 && options.placement != "key") {
+            std::cerr << "Release diff places each definition at its own sorted position; it cannot be used with --placement " << options.placement << "." << std::endl;
+            return -1;
         }
-        else if (section_location != std::string::npos) {
-            prefix.erase(section_location,7);
-            prefix.insert(section_location,"§");
+        jobs.emplace_back();
+        int diff_result = readReleaseDiff(arguments.at(1), arguments.at(2), jobs.back());
+        if (diff_result != 0) {
+            return diff_result;
         }
-    }
-    if (prefix.empty()) {
-        std::cout << "No Prefix" << std::endl;
+        if (jobs.back().java_identifier.empty()) {
+            std::cout << "No definitions were added or changed; nothing to port." << std::endl;
+            return 0;
+        }
+        options.placement = "key"; //The definitions are unrelated, so each goes to its own place
     }
     else {
-        std::cout << "Prefix (Replaced SECTION with §): " << prefix << std::endl;
-    }
-
-    //Suffix
-    std::string suffix;
-    if (argc > 5) {
-        suffix = argv[5];
-        size_t section_location = suffix.find("SECTION");
-        if (suffix == "NULL") {
-            suffix = "";
+        if (arguments.size() < 3) {
+            std::cerr << "Usage: (required) ./translation_translator <s/m/c/n/p> <base_java_identifier> <base_bedrock_identifier> (optional) <prefix> <suffix> <sort_override>" << std::endl;
+            std::cerr << "Batch usage: ./translation_translator b <job_file>" << std::endl;
+            std::cerr << "Release diff usage: ./translation_translator d <old_java_folder> <key_map_file>" << std::endl;
+            std::cerr << "Key map analysis usage: ./translation_translator a <key_map_file> (optional) <java_folder>" << std::endl;
+            std::cerr << "Options: --jobs <thread_count> --reader <raw/sax/dom> --placement <block/key> --on-conflict <duplicate/replace/skip/error> --sync --cache --incremental --pipeline --profile(=<json_file>)" << std::endl;
+            return -1;
         }
-        else if (section_location != std::string::npos) {
-            suffix.erase(section_location,7);
-            suffix.insert(section_location,"§");
+        jobs.emplace_back();
+        int parse_result = parseJob(arguments, jobs.back());
+        if (parse_result != 0) {
+            return parse_result;
         }
     }
-    if (suffix.empty()) {
-        std::cout << "No Suffix" << std::endl;
-    }
-    else {
-        std::cout << "Suffix (Replaced SECTION with §): " << suffix << std::endl;
-    }
 
-    //Sort override (start of alphabetical comparisons)
-    std::string sort_override;
-    bool sort_override_enabled = false;
-    if (argc > 6) {
-        sort_override = argv[6];
-        if (sort_override == "NULL") {
-            sort_override = "";
-        }
-    }
-    if (sort_override.empty()) {
-        std::cout << "No Sort Override" << std::endl << std::endl;
-    }
-    else {
-        sort_override_enabled = true;
-        std::cout << "Start Sort At: " << sort_override << std::endl << std::endl;
-    }
+    input_phase.finish();
 
 //////
 //////  CONFIG FILES
 //////
 
+    Profiler::Phase config_phase(profiler.get(), "", "config");
+
     //Language list
     std::vector<std::string> java_language, bedrock_language;
     if (readConfigFile("languages.txt",java_language,bedrock_language) != 0) {
@@ -131,289 +112,152 @@ int main(int argc, char* argv[]) {
         return -2;
     }
 
-    //Identifier expansion
-    std::vector<std::string> java_identifier, bedrock_identifier;
-    if (expansion_type == 's') { //Single line, no expansion
-        java_identifier.push_back(base_java_identifier); //Use same system for single identifier to be as easy as possible
-        bedrock_identifier.push_back(base_bedrock_identifier);
-    }
-    //Multiple or colors expansions
-    else {
-        std::vector<std::string> java_multiple, bedrock_multiple;
-        std::string config_file = "multiple.txt";
-        if (expansion_type == 'c') {
-            config_file = "colors_classic.txt";
-        }
-        else if (expansion_type == 'n'){
-            config_file = "colors_new.txt";
-        }
-        if (readConfigFile(config_file, java_multiple, bedrock_multiple) != 0) {
-            std::cerr << "Aborted. Failed to read " << config_file << "." << std::endl;
-            return -3;
-        }
-        if (expandIdentifier(base_java_identifier, java_identifier, java_multiple) != 0) {
-            std::cerr << "Failed to expand list of Java identifiers." << std::endl;
-            return -4;
-        }
-        if (expandIdentifier(base_bedrock_identifier, bedrock_identifier, bedrock_multiple) != 0) {
-            std::cerr << "Failed to expand list of Bedrock identifiers." << std::endl;
-            return -5;
+    //Identifier expansion; pattern jobs share one sorted list of the en_us keys
+    std::vector<std::string> en_us_keys;
+    for (auto & job : jobs) {
+        int expand_result = expandJob(job, en_us_keys);
+        if (expand_result != 0) {
+            return expand_result;
         }
     }
 
-//////
-//////  READ JAVA DEFINITIONS
-//////
+    config_phase.finish();
 
-    //Iterate through every language
-    for (int i = 0; i < bedrock_language.size(); i++) {
+    //Languages last ported from the same files with the same jobs are skipped
+    std::unique_ptr<PortManifest> manifest;
+    if (options.incremental) {
+        manifest = std::make_unique<PortManifest>(hashJobs(jobs, options));
+        manifest->load(".cache/manifest.txt");
+    }
 
-        std::ifstream fin("lang_java/" + java_language.at(i) + ".json", std::ios_base::app);
-        if (fin.fail()) {
-            std::cerr << "Failed to open lang_java/" + java_language.at(i) + ".json." << std::endl;
-            return -6;
+    //Port every language; each file is read and written once for all jobs
+    int port_result;
+    if (options.pipeline) {
+        port_result = runPipeline(java_language, bedrock_language, jobs, options, profiler.get(), manifest.get());
+    }
+    else {
+        std::vector<uint64_t> language_bytes;
+        for (size_t i = 0; i < bedrock_language.size(); i++) {
+            language_bytes.push_back(options.thread_count > 1 ? languageBytes(java_language.at(i), bedrock_language.at(i), options) : 0);
         }
-        std::cout << "Opened " + java_language.at(i) + ".json..." << std::endl;
-
-        //Read all necessary defs, store in vector
-        json java_json = json::parse(fin);
-        std::string current_string;
-        std::vector<std::string> definition;
-        bool identifier_found = false; //For error checking
+        port_result = runLanguages(bedrock_language.size(), options.thread_count, language_bytes, profiler.get(), [&](size_t i, std::ostream &out, std::ostream &err) {
+            return portLanguage(java_language.at(i), bedrock_language.at(i), jobs, options, profiler.get(), manifest.get(), out, err);
+        });
+    }
 
-        for (const auto & j : java_identifier) {
-            if (java_json.contains(j)) {
-                current_string = java_json[j];
-                current_string.insert(0,prefix);
-                current_string += suffix;
-                definition.push_back(current_string);
-                identifier_found = true;
-            }
-            else {
-                std::cerr << "Failed to find " << j << " in " << java_language.at(i) << ".json." << std::endl;
-                definition.emplace_back("NULL");
-            }
-        }
-        fin.close();
-        std::cout << "Finished reading " + java_language.at(i) + ".json..." << std::endl;
+    //Kept even when a language failed, so the languages that did finish are skipped next time
+    if (manifest && !manifest->save(".cache/manifest.txt")) {
+        std::cerr << "Failed to write .cache/manifest.txt." << std::endl;
+    }
 
-        //Check any identifier was found in file
-        if (!identifier_found) {
-            std::cerr << "Aborted; no matching definitions found." << std::endl;
-            return -7;
+    //Files are replaced by rename, so one sync at the end makes the whole run durable
+    if (options.sync_at_end) {
+        Profiler::Phase sync_phase(profiler.get(), "", "sync");
+        if (!syncFileSystem("lang_bedrock")) {
+            std::cerr << "Failed to sync lang_bedrock to disk." << std::endl;
         }
+    }
 
-        //Check for size error
-        if (java_identifier.size() != definition.size()) {
-            std::cerr << "Aborted; Java identifiers and definitions desynchronized." << std::endl;
-            return -8;
+    if (profiler) {
+        profiler->printSummary(std::cout);
+        std::cout << std::endl;
+        if (!options.profile_path.empty() && !profiler->writeJson(options.profile_path)) {
+            std::cerr << "Failed to write profile to " << options.profile_path << "." << std::endl;
         }
+    }
+    if (port_result != 0) {
+        return port_result;
+    }
 
-//////
-//////  WRITE BEDROCK DEFINITIONS
-//////
-
-        //Append output definitions
-        std::ifstream copyin("lang_bedrock/" + bedrock_language.at(i) + ".lang");
-        if (copyin.fail()) {
-            std::cerr << "Failed to open lang_bedrock/" + bedrock_language.at(i) + ".lang." << std::endl;
-            return -9;
-        }
-        std::cout << "Opened existing " + bedrock_language.at(i) + ".lang..." << std::endl;
+    std::cout << "Task completed successfully!" << std::endl;
+}
 
-        //Find correct insertion location in lang file
-        std::string clean_identifier = base_bedrock_identifier;
-        std::string alphabetical_identifier, after_first_period;
-        if (!sort_override_enabled) {
-            if (expansion_type != 's') { //Remove VAR part of string
-                clean_identifier = base_bedrock_identifier.substr(0, base_bedrock_identifier.find("VAR"));
-            }
-            size_t first_period = clean_identifier.find('.');
-            if (first_period != std::string::npos) {
-                alphabetical_identifier = clean_identifier.substr(0,first_period);
-            }
-            else {
-                alphabetical_identifier = clean_identifier;
-            }
-        }
-        else {
-            alphabetical_identifier = sort_override;
-        }
+//Separates run options (--name value, --name=value, or a --flag) from positional arguments
+//given_options collects the name of every option that appeared, for modes whose defaults differ
+int parseOptions(int argc,char* argv[],RunOptions &options,std::vector<std::string> &arguments,std::unordered_set<std::string> &given_options) {
 
-        //Unmodified text handling
-        std::string current_line, trimmed_line;
-        std::vector<std::string> pre_insertion_file, post_insertion_file;
-        bool insert_end = false;
+    const std::unordered_set<std::string> flag_options = {"--sync", "--cache", "--incremental", "--pipeline", "--profile"}; //Options that never take a value, except --profile=file
 
-        //Find similar structure to base identifier
-        while (!copyin.eof() && alphabetical_identifier != trimmed_line) {
-            getline(copyin, current_line, '\n');
-            pre_insertion_file.push_back(current_line); //Build file
-            if (current_line.size() > alphabetical_identifier.size()) { //Trim current line to match alphabetical identifier
-                trimmed_line = current_line.substr(0, alphabetical_identifier.size());
-            }
-            else {
-                trimmed_line = current_line;
-            }
-            //Check for duplicate definitions
-            for (const auto & j : bedrock_identifier) {
-                if (j == current_line.substr(0,current_line.find('='))) {
-                    std::cerr << "Duplicate definition found in " << bedrock_language.at(i) << " on line " << pre_insertion_file.size() << "." << std::endl;
-                }
-            }
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+        if (argument.rfind("--", 0) != 0) {
+            arguments.push_back(argument);
+            continue;
         }
-        //Start alphabetical search through current location
-        while (!copyin.eof() && current_line < bedrock_identifier.at(0) && !(sort_override_enabled && current_line.empty())) { //In sort override, an empty line stops alpha search
-            getline(copyin, current_line, '\n');
-            pre_insertion_file.push_back(current_line); //Continue to build file
 
-            //Check for duplicate definitions
-            for (const auto & j : bedrock_identifier) {
-                if (j == current_line.substr(0,current_line.find('='))) {
-                    std::cerr << "Duplicate definition found in " << bedrock_language.at(i) << " on line " << pre_insertion_file.size() << "." << std::endl;
-                }
-            }
+        //Split option name and value
+        std::string name = argument, value;
+        size_t equals_location = argument.find('=');
+        if (equals_location != std::string::npos) {
+            name = argument.substr(0, equals_location);
+            value = argument.substr(equals_location + 1);
         }
-        //Sometimes, no similar definition is found
-        if (copyin.eof()) {
-            if (!sort_override_enabled) {
-                std::cerr << "No similar identifiers found; inserting new lines at end of file." << std::endl;
-            }
-            else {
-                std::cerr << "No existing identifiers found matching sort override \"" << sort_override << "\"; inserting new lines at end of file." << std::endl;
-            }
-            insert_end = true;
+        else if (flag_options.count(name) == 0 && i + 1 < argc) {
+            value = argv[++i];
         }
-        //Otherwise, save the rest of the file
-        else {
-            while (!copyin.eof()) { //Finish reading file
-                getline(copyin, current_line, '\n');
-                post_insertion_file.push_back(current_line);
+        given_options.insert(name);
 
-                //Check for duplicate definitions
-                for (const auto & j : bedrock_identifier) {
-                    if (j == current_line.substr(0,current_line.find('='))) {
-                        std::cerr << "Duplicate definition found in " << bedrock_language.at(i) << " on line " << pre_insertion_file.size() + post_insertion_file.size() << "." << std::endl;
-                    }
-                }
-            }
+        if (name == "--sync") {
+            options.sync_at_end = true;
         }
-        copyin.close();
-        //Remove trailing whitespace
-        if (!post_insertion_file.empty()) {
-            while (post_insertion_file.back().empty() && !post_insertion_file.empty()) {
-                post_insertion_file.pop_back();
-            }
+        else if (name == "--cache") {
+            options.use_cache = true;
         }
-
-        //Insert output definitions
-        std::ofstream fout("lang_bedrock/" + bedrock_language.at(i) + ".lang");
-        if (fout.fail()) {
-            std::cerr << "Failed to open lang_bedrock/" + bedrock_language.at(i) + ".lang." << std::endl;
-            return -10;
+        else if (name == "--incremental") {
+            options.incremental = true;
         }
-        std::cout << "Overwrote " + bedrock_language.at(i) + ".lang..." << std::endl;
-
-        //Print pre-insertion until lines the program is adding
-        for (int j = 0; j < pre_insertion_file.size() - 1; j++) {
-            fout << pre_insertion_file.at(j) << std::endl;
+        else if (name == "--pipeline") {
+            options.pipeline = true;
         }
-
-        //Add extra space for end insertion
-        if (insert_end) {
-            fout << pre_insertion_file.at(pre_insertion_file.size() - 1) << std::endl;
+        else if (name == "--profile") {
+            options.profile = true;
+            options.profile_path = value;
         }
-
-        //Print new lines to Bedrock output file
-        for (int k = 0; k < definition.size(); k++) {
-            if (definition.at(k) != "NULL") {
-                fout << bedrock_identifier.at(k) << "=" << definition.at(k);
-                if (bedrock_language.at(i) != "en_US") {
-                    fout << "\t#" << std::endl;
-                }
-                else {
-                    fout << std::endl;
-                }
+        else if (name == "--jobs") {
+            try {
+                options.thread_count = std::stoi(value);
             }
-            else {
-                std::cerr << "Skipped missing definition for " << java_identifier.at(k) << " -> " << bedrock_identifier.at(k) << " (Java -> Bedrock)." << std::endl;
+            catch (const std::exception &) {
+                options.thread_count = -1;
+            }
+            if (options.thread_count < 0) {
+                std::cerr << "Option --jobs needs a thread count of 0 (all cores) or more." << std::endl;
+                return -1;
+            }
+            if (options.thread_count == 0) {
+                options.thread_count = std::max(1u, std::thread::hardware_concurrency());
             }
         }
-
-        //Print remaining lines
-        if (!insert_end) {
-            fout << pre_insertion_file.at(pre_insertion_file.size() - 1) << std::endl;
-            if (!post_insertion_file.empty()) {
-                for (const auto &l: post_insertion_file) {
-                    fout << l << std::endl;
-                }
+        else if (name == "--reader") {
+            if (value != "raw" && value != "sax" && value != "dom") {
+                std::cerr << "Option --reader must be raw, sax or dom." << std::endl;
+                return -1;
             }
+            options.java_reader = value;
         }
-
-        fout.close();
-        std::cout << "Finished writing to " + bedrock_language.at(i) + ".lang..." << std::endl << std::endl;
-    }
-
-    std::cout << "Task completed successfully!" << std::endl;
-}
-
-//Builds list identifiers using expansion words and stores in identifier_list
-int expandIdentifier(std::string base_identifier,std::vector<std::string> &identifier_list,const std::vector<std::string> &expansion_list) {
-
-    size_t insertion_point = base_identifier.find("VAR");
-    if (insertion_point == std::string::npos) {
-        std::cerr << "Text \"VAR\" not found in input string." << std::endl;
-        return -1;
-    }
-    base_identifier.erase(insertion_point,3);
-
-    std::string current_identifier;
-    for (const auto & i : expansion_list) { //Iterate through full expansion list
-        current_identifier = base_identifier;
-        current_identifier.insert(insertion_point,i); //Insert expansion into string
-        identifier_list.push_back(current_identifier); //Add to vector
-    }
-
-    std::cout << "Created the following identifiers:" << std::endl;
-    for (const auto & i : identifier_list) {
-        std::cout << i << std::endl;
-    }
-    std::cout << std::endl;
-
-    return 0;
-}
-
-//Reads config file (in two-column Java/Bedrock format) into provided vectors
-int readConfigFile(const std::string& input_filename,std::vector<std::string> &java_vector,std::vector<std::string> &bedrock_vector) {
-
-    //Open config file
-    std::ifstream fin(input_filename);
-    if (fin.fail()) {
-        std::cerr << "Failed to open " << input_filename << "." << std::endl;
-        return -1;
-    }
-    std::cout << "Opened " << input_filename << "..." << std::endl;
-
-    std::string input;
-    int cycle = 0; //For alternating Bedrock and Java
-    while (!fin.eof()) {
-        fin >> input;
-        if (cycle % 2 == 0) {
-            java_vector.push_back(input);
+        else if (name == "--placement") {
+            if (value != "block" && value != "key") {
+                std::cerr << "Option --placement must be block or key." << std::endl;
+                return -1;
+            }
+            options.placement = value;
+        }
+        else if (name == "--on-conflict") {
+            if (value != "duplicate" && value != "replace" && value != "skip" && value != "error") {
+                std::cerr << "Option --on-conflict must be duplicate, replace, skip or error." << std::endl;
+                return -1;
+            }
+            options.on_conflict = value;
         }
         else {
-            bedrock_vector.push_back(input); //Push every other word to Bedrock
+            std::cerr << "Option " << name << " not recognized." << std::endl;
+            return -1;
         }
-        cycle++;
     }
-    fin.close();
-    std::cout << "Closed " << input_filename << "..." << std::endl << std::endl;
-
-    //Error checker
-    if (java_vector.size() != bedrock_vector.size()) {
-        std::cerr << "Input file " << input_filename << "does not have an equal number of Java and Bedrock definitions, or file was empty." << std::endl;
-        return -2;
+    if (options.pipeline && options.thread_count > 1) { //Each pipeline stage already runs on its own thread
+        std::cerr << "Options --pipeline and --jobs cannot be used together." << std::endl;
+        return -1;
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,295 @@
+#include "platform.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <system_error>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#include <psapi.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::prefetch() const {
+#ifndef _WIN32
+    if (length > 0) {
+        madvise(const_cast<char *>(data), length, MADV_WILLNEED);
+    }
+#endif
+    //Touching one byte per page makes the system read the whole file now
+    volatile char sink = 0;
+    for (size_t offset = 0; offset < length; offset += 4096) {
+        sink = sink + data[offset];
+    }
+}
+
+#ifdef _WIN32
+
+void setupConsole() {
+    // Set console code page to UTF-8 so console known how to interpret string data
+    SetConsoleOutputCP(CP_UTF8);
+
+    // Enable buffering to prevent VS from chopping up UTF-8 byte sequences
+    setvbuf(stdout, nullptr, _IOFBF, 1000);
+}
+
+bool MappedFile::open(const std::string &path) {
+    close();
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        file_handle = nullptr;
+        return false;
+    }
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file_handle, &file_size)) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(file_size.QuadPart);
+    if (length == 0) { //Empty files cannot be mapped
+        return true;
+    }
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        close();
+        return false;
+    }
+    data = static_cast<const char *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (data == nullptr) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+    }
+    if (file_handle != nullptr) {
+        CloseHandle(file_handle);
+    }
+    data = nullptr;
+    length = 0;
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+}
+
+
+bool writeFileRanges(const std::string &path,const std::vector<std::string_view> &ranges) {
+    HANDLE output_handle = CreateFileA(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (output_handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    //WriteFileGather needs page-sized buffers, so ranges are written one call each
+    bool success = true;
+    for (std::string_view range : ranges) {
+        while (success && !range.empty()) {
+            DWORD chunk = static_cast<DWORD>(std::min<size_t>(range.size(), 1u << 30));
+            DWORD written = 0;
+            success = WriteFile(output_handle, range.data(), chunk, &written, nullptr) != 0;
+            range.remove_prefix(written);
+        }
+    }
+    return CloseHandle(output_handle) != 0 && success;
+}
+
+bool replaceFile(const std::string &source_path,const std::string &target_path) {
+    return MoveFileExA(source_path.c_str(), target_path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
+
+//Windows can only flush files through their own handles, so each file in directory is opened and flushed
+bool syncFileSystem(const std::string &directory) {
+    std::error_code error;
+    std::filesystem::directory_iterator files(directory, error);
+    if (error) {
+        return false;
+    }
+    bool success = true;
+    for (const auto & file : files) {
+        if (!file.is_regular_file(error)) {
+            continue;
+        }
+        HANDLE flush_handle = CreateFileW(file.path().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (flush_handle == INVALID_HANDLE_VALUE) {
+            success = false;
+            continue;
+        }
+        success = FlushFileBuffers(flush_handle) != 0 && success;
+        CloseHandle(flush_handle);
+    }
+    return success;
+}
+
+unsigned long currentProcessId() {
+    return GetCurrentProcessId();
+}
+
+size_t peakMemoryBytes() {
+    PROCESS_MEMORY_COUNTERS counters {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize;
+}
+
+#else
+
+//POSIX terminals already expect UTF-8; only the buffering is shared with Windows
+void setupConsole() {
+    setvbuf(stdout, nullptr, _IOFBF, 1000);
+}
+
+bool MappedFile::open(const std::string &path) {
+    close();
+    file_descriptor = ::open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        return false;
+    }
+    struct stat file_status {};
+    if (fstat(file_descriptor, &file_status) != 0) {
+        close();
+        return false;
+    }
+    length = static_cast<size_t>(file_status.st_size);
+    if (length == 0) { //Empty files cannot be mapped
+        return true;
+    }
+    void *mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+    madvise(mapping, length, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(mapping);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        munmap(const_cast<char *>(data), length);
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+    }
+    data = nullptr;
+    length = 0;
+    file_descriptor = -1;
+}
+
+bool writeFileRanges(const std::string &path,const std::vector<std::string_view> &ranges) {
+    int output_descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    if (output_descriptor < 0) {
+        return false;
+    }
+    std::vector<iovec> vectors;
+    vectors.reserve(ranges.size());
+    for (std::string_view range : ranges) {
+        if (!range.empty()) {
+            vectors.push_back({const_cast<char *>(range.data()), range.size()});
+        }
+    }
+
+    //writev takes at most IOV_MAX ranges and may stop partway through one
+    bool success = true;
+    size_t next_vector = 0;
+    while (next_vector < vectors.size()) {
+        int count = static_cast<int>(std::min<size_t>(vectors.size() - next_vector, IOV_MAX));
+        ssize_t written = ::writev(output_descriptor, &vectors.at(next_vector), count);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            success = false;
+            break;
+        }
+        size_t remaining = static_cast<size_t>(written);
+        while (next_vector < vectors.size() && remaining >= vectors.at(next_vector).iov_len) {
+            remaining -= vectors.at(next_vector).iov_len;
+            next_vector++;
+        }
+        if (remaining > 0) {
+            vectors.at(next_vector).iov_base = static_cast<char *>(vectors.at(next_vector).iov_base) + remaining;
+            vectors.at(next_vector).iov_len -= remaining;
+        }
+    }
+    return ::close(output_descriptor) == 0 && success;
+}
+
+bool replaceFile(const std::string &source_path,const std::string &target_path) {
+    struct stat target_status {};
+    if (stat(target_path.c_str(), &target_status) == 0) {
+        chmod(source_path.c_str(), target_status.st_mode & 07777);
+    }
+    return std::rename(source_path.c_str(), target_path.c_str()) == 0;
+}
+
+bool syncFileSystem(const std::string &directory) {
+#ifdef __linux__
+    int directory_descriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory_descriptor < 0) {
+        return false;
+    }
+    bool success = syncfs(directory_descriptor) == 0;
+    ::close(directory_descriptor);
+    return success;
+#else
+    (void)directory;
+    sync();
+    return true;
+#endif
+}
+
+unsigned long currentProcessId() {
+    return static_cast<unsigned long>(getpid());
+}
+
+size_t peakMemoryBytes() {
+    struct rusage usage {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<size_t>(usage.ru_maxrss); //Bytes on macOS
+#else
+    return static_cast<size_t>(usage.ru_maxrss) * 1024; //Kilobytes elsewhere
+#endif
+}
+
+#endif
+
+bool fileStatus(const std::string &path,uint64_t &size,int64_t &time) {
+    std::error_code error;
+    size = std::filesystem::file_size(path, error);
+    if (error) {
+        return false;
+    }
+    time = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    return !error;
+}
+
+uint64_t hashText(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : text) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,63 @@
+#ifndef TRANSLATION_PORTER_PLATFORM_H
+#define TRANSLATION_PORTER_PLATFORM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+//Prepares the console for printing UTF-8 definitions
+void setupConsole();
+
+//Read-only view of a whole file mapped into memory
+//The view stays valid until close() or destruction; the file must not be rewritten while mapped
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool open(const std::string &path);
+    void close();
+
+    //Reads every page of the file into memory now, instead of on first use
+    void prefetch() const;
+
+    std::string_view view() const { return {data, length}; }
+    size_t size() const { return length; }
+
+private:
+    const char *data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#else
+    int file_descriptor = -1;
+#endif
+};
+
+//Writes byte ranges in order to a new or truncated file, in as few system calls as possible
+bool writeFileRanges(const std::string &path,const std::vector<std::string_view> &ranges);
+
+//Atomically moves a finished file over target_path, keeping the target's permissions
+bool replaceFile(const std::string &source_path,const std::string &target_path);
+
+//Flushes every written file on the file system holding directory to disk; on Windows, the files in directory
+bool syncFileSystem(const std::string &directory);
+
+//Highest resident memory of this process so far, in bytes
+size_t peakMemoryBytes();
+
+//Identifies this run, for naming temporary files that parallel runs will not share
+unsigned long currentProcessId();
+
+//Size and last write time (in file clock ticks) of a file; false when it does not exist
+bool fileStatus(const std::string &path,uint64_t &size,int64_t &time);
+
+//FNV-1a, for telling whether a file whose write time changed still has the same contents
+uint64_t hashText(std::string_view text);
+
+#endif
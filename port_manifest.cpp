@@ -0,0 +1,148 @@
+#include "port_manifest.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include "platform.h"
+
+namespace {
+
+const char manifest_header[] = "translation_porter manifest 1";
+
+}
+
+void PortManifest::load(const std::string &path) {
+
+    entries.clear();
+    std::ifstream fin(path);
+    std::string line;
+    if (!std::getline(fin, line) || line != manifest_header) {
+        return;
+    }
+
+    //java_language bedrock_language job_hash java_size java_time java_hash lang_size lang_time lang_hash
+    while (std::getline(fin, line)) {
+        if (fin.eof()) { //save ends every entry with a newline, so a last line without one was cut short
+            entries.clear();
+            return;
+        }
+        std::istringstream fields(line);
+        std::string java_language, bedrock_language;
+        Entry entry;
+        if (!(fields >> java_language >> bedrock_language >> entry.job_hash
+              >> entry.java_file.size >> entry.java_file.time >> entry.java_file.hash
+              >> entry.lang_file.size >> entry.lang_file.time >> entry.lang_file.hash)) {
+            entries.clear();
+            return;
+        }
+        entries[java_language + " " + bedrock_language] = entry;
+    }
+}
+
+bool PortManifest::save(const std::string &path) const {
+
+    std::ostringstream text;
+    text << manifest_header << "\n";
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        for (const auto & [languages, entry] : entries) {
+            text << languages << " " << entry.job_hash << " "
+                 << entry.java_file.size << " " << entry.java_file.time << " " << entry.java_file.hash << " "
+                 << entry.lang_file.size << " " << entry.lang_file.time << " " << entry.lang_file.hash << "\n";
+        }
+    }
+
+    //Written beside the manifest and renamed, so an interrupted run leaves the old one whole
+    std::error_code error;
+    std::filesystem::create_directories(std::filesystem::path(path).parent_path(), error);
+    std::string contents = text.str();
+    std::string temp_path = path + "." + std::to_string(currentProcessId()) + ".tmp";
+    if (!writeFileRanges(temp_path, {contents}) || !replaceFile(temp_path, path)) {
+        std::remove(temp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool PortManifest::unchanged(const std::string &java_language,const std::string &bedrock_language) {
+
+    Entry entry;
+    std::string languages = java_language + " " + bedrock_language;
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        auto found = entries.find(languages);
+        if (found == entries.end() || found->second.job_hash != job_hash) {
+            return false;
+        }
+        entry = found->second;
+    }
+    if (!matches("lang_java/" + java_language + ".json", entry.java_file) || !matches("lang_bedrock/" + bedrock_language + ".lang", entry.lang_file)) {
+        return false;
+    }
+
+    //Keep the new write times, so the next run does not read the files again
+    std::lock_guard<std::mutex> lock(manifest_mutex);
+    entries[languages] = entry;
+    return true;
+}
+
+void PortManifest::record(const std::string &java_language,const std::string &bedrock_language) {
+
+    Entry entry;
+    entry.job_hash = job_hash;
+    std::string languages = java_language + " " + bedrock_language;
+    {
+        //An unchanged Java file keeps its hash instead of being read again
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        auto found = entries.find(languages);
+        if (found != entries.end()) {
+            entry.java_file = found->second.java_file;
+        }
+    }
+    FileState java_state = entry.java_file;
+    if (!fileStatus("lang_java/" + java_language + ".json", java_state.size, java_state.time)) {
+        return;
+    }
+    if (java_state.size != entry.java_file.size || java_state.time != entry.java_file.time) {
+        if (!readState("lang_java/" + java_language + ".json", java_state)) {
+            return;
+        }
+    }
+    entry.java_file = java_state;
+    if (!readState("lang_bedrock/" + bedrock_language + ".lang", entry.lang_file)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(manifest_mutex);
+    entries[languages] = entry;
+}
+
+bool PortManifest::matches(const std::string &path,FileState &state) {
+
+    uint64_t size;
+    int64_t time;
+    if (!fileStatus(path, size, time) || size != state.size) {
+        return false;
+    }
+    if (time == state.time) {
+        return true;
+    }
+    MappedFile file;
+    if (!file.open(path) || hashText(file.view()) != state.hash) {
+        return false;
+    }
+    state.time = time;
+    return true;
+}
+
+bool PortManifest::readState(const std::string &path,FileState &state) {
+
+    MappedFile file;
+    if (!fileStatus(path, state.size, state.time) || !file.open(path)) {
+        return false;
+    }
+    state.hash = hashText(file.view());
+    return true;
+}
@@ -0,0 +1,47 @@
+#ifndef TRANSLATION_PORTER_PORT_MANIFEST_H
+#define TRANSLATION_PORTER_PORT_MANIFEST_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+//Inputs and output of each language's last successful port, kept between runs in a text file
+//A language whose Java file, Bedrock file and jobs all match its entry would come out the same, so it can be skipped
+class PortManifest {
+public:
+    //job_hash identifies the jobs and options of this run
+    explicit PortManifest(uint64_t job_hash) : job_hash(job_hash) {}
+
+    //Reads the entries at path; a missing or damaged manifest leaves no entries, so every language is ported
+    void load(const std::string &path);
+    bool save(const std::string &path) const;
+
+    //True when both files still match the entry left by a port with the same jobs
+    //A file is only read when its size matches but its write time does not
+    bool unchanged(const std::string &java_language,const std::string &bedrock_language);
+
+    //Records both files after the language was ported
+    void record(const std::string &java_language,const std::string &bedrock_language);
+
+private:
+    struct FileState {
+        uint64_t size = 0;
+        int64_t time = 0;
+        uint64_t hash = 0;
+    };
+    struct Entry {
+        uint64_t job_hash = 0;
+        FileState java_file, lang_file;
+    };
+
+    //Updates state's write time when only that changed; false when the contents differ
+    static bool matches(const std::string &path,FileState &state);
+    static bool readState(const std::string &path,FileState &state);
+
+    uint64_t job_hash;
+    std::map<std::string, Entry> entries; //By "java_language bedrock_language"
+    mutable std::mutex manifest_mutex; //Languages are checked and recorded from several threads
+};
+
+#endif
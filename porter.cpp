@@ -0,0 +1,1691 @@
+#include "porter.h"
+
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <tuple>
+#include "json.hpp"
+#include "java_cache.h"
+#include "json_arena.h"
+#include "json_scanner.h"
+#include "lang_tokenizer.h"
+#include "bounded_queue.h"
+using json = nlohmann::json;
+
+//SAX handler that keeps the top-level string values of the wanted keys
+//Without a wanted key set, every top-level string value is kept; the last value of a repeated key wins, as with json::parse
+class SelectiveExtractor : public nlohmann::json_sax<json> {
+public:
+    SelectiveExtractor(const std::unordered_set<std::string> *wanted_keys,std::unordered_map<std::string, std::string> &values) : wanted_keys(wanted_keys), values(values) {}
+
+    bool null() override { return skipValue(); }
+    bool boolean(bool) override { return skipValue(); }
+    bool number_integer(number_integer_t) override { return skipValue(); }
+    bool number_unsigned(number_unsigned_t) override { return skipValue(); }
+    bool number_float(number_float_t, const string_t &) override { return skipValue(); }
+    bool binary(binary_t &) override { return skipValue(); }
+
+    bool string(string_t &value) override {
+        if (depth == 1 && key_wanted) {
+            values.insert_or_assign(std::move(current_key), std::move(value));
+            key_wanted = false;
+        }
+        return true;
+    }
+
+    bool key(string_t &key) override {
+        if (depth == 1) {
+            key_wanted = wanted_keys == nullptr || wanted_keys->count(key) != 0;
+            if (key_wanted) {
+                current_key = key;
+            }
+        }
+        return true;
+    }
+
+    bool start_object(std::size_t) override {
+        skipValue();
+        depth++;
+        return true;
+    }
+    bool end_object() override {
+        depth--;
+        return true;
+    }
+    bool start_array(std::size_t) override {
+        skipValue();
+        depth++;
+        return true;
+    }
+    bool end_array() override {
+        depth--;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string &, const nlohmann::detail::exception &) override {
+        return false;
+    }
+
+private:
+    //Any value that is not a string is not a definition, and replaces an earlier definition of its key
+    bool skipValue() {
+        if (key_wanted) {
+            values.erase(current_key);
+        }
+        key_wanted = false;
+        return true;
+    }
+
+    const std::unordered_set<std::string> *wanted_keys;
+    std::unordered_map<std::string, std::string> &values;
+    std::string current_key;
+    bool key_wanted = false;
+    int depth = 0; //Definitions are members of the top-level object, at depth 1
+};
+
+//Validates and stores one job's arguments: <s/m/c/n/p> <java_identifier> <bedrock_identifier> <prefix> <suffix> <sort_override>
+int parseJob(const std::vector<std::string> &arguments,PortJob &job) {
+
+    // VAR converts to the multiple definitions or the colors in identifiers
+    // SECTION converts to § in prefix and suffix
+    // NULL indicates to exclude that argument, for the optional args
+    if (arguments.size() < 3) {
+        std::cerr << "Usage: (required) ./translation_translator <s/m/c/n/p> <base_java_identifier> <base_bedrock_identifier> (optional) <prefix> <suffix> <sort_override>" << std::endl;
+        return -1;
+    }
+    std::cout << "User-Defined Configuration: " << std::endl;
+
+    //Expansion type
+    job.expansion_type = arguments.at(0).empty() ? ' ' : arguments.at(0).at(0);
+    if (job.expansion_type == 's') {
+        std::cout << "Expansion Type: Single" << std::endl;
+    }
+    else if (job.expansion_type == 'm') {
+        std::cout << "Expansion Type: Multiple; reads from \"multiple.txt\"." << std::endl;
+    }
+    else if (job.expansion_type == 'c') {
+        std::cout << "Expansion Type: 16 Colors (Original Names); reads from \"colors_classic.txt\"." << std::endl;
+    }
+    else if (job.expansion_type == 'n') {
+        std::cout << "Expansion Type: 16 Colors (New Names); reads from \"colors_new.txt\"." << std::endl;
+    }
+    else if (job.expansion_type == 'p') {
+        std::cout << "Expansion Type: Pattern; matches keys of \"lang_java/en_us.json\"." << std::endl;
+    }
+    else {
+        std::cerr << "Expansion type not recognized. Valid characters are s (single), m (multiple), c (classic color), n (new color), or p (pattern)." << std::endl;
+        return -10;
+    }
+
+    //Java identifier
+    job.base_java_identifier = arguments.at(1);
+    std::cout << "Base Java Identifier: " << job.base_java_identifier << std::endl;
+
+    //Bedrock identifier
+    job.base_bedrock_identifier = arguments.at(2);
+    std::cout << "Base Bedrock Identifier: " << job.base_bedrock_identifier << std::endl;
+
+    //Prefix
+    if (arguments.size() > 3) {
+        job.prefix = arguments.at(3);
+        size_t section_location = job.prefix.find("SECTION");
+        if (job.prefix == "NULL") {
+            job.prefix = "";
+        }
+        else if (section_location != std::string::npos) {
+            job.prefix.erase(section_location,7);
+            job.prefix.insert(section_location,"§");
+        }
+    }
+    if (job.prefix.empty()) {
+        std::cout << "No Prefix" << std::endl;
+    }
+    else {
+        std::cout << "Prefix (Replaced SECTION with §): " << job.prefix << std::endl;
+    }
+
+    //Suffix
+    if (arguments.size() > 4) {
+        job.suffix = arguments.at(4);
+        size_t section_location = job.suffix.find("SECTION");
+        if (job.suffix == "NULL") {
+            job.suffix = "";
+        }
+        else if (section_location != std::string::npos) {
+            job.suffix.erase(section_location,7);
+            job.suffix.insert(section_location,"§");
+        }
+    }
+    if (job.suffix.empty()) {
+        std::cout << "No Suffix" << std::endl;
+    }
+    else {
+        std::cout << "Suffix (Replaced SECTION with §): " << job.suffix << std::endl;
+    }
+
+    //Sort override (start of alphabetical comparisons)
+    if (arguments.size() > 5) {
+        job.sort_override = arguments.at(5);
+        if (job.sort_override == "NULL") {
+            job.sort_override = "";
+        }
+    }
+    if (job.sort_override.empty()) {
+        std::cout << "No Sort Override" << std::endl << std::endl;
+    }
+    else {
+        job.sort_override_enabled = true;
+        std::cout << "Start Sort At: " << job.sort_override << std::endl << std::endl;
+    }
+
+    return 0;
+}
+
+//Builds the real Java and Bedrock identifiers of a job from its base identifiers
+int expandJob(PortJob &job,std::vector<std::string> &en_us_keys) {
+
+    if (job.expansion_type == 'd') { //Release diff jobs are built with their identifiers
+        return 0;
+    }
+    if (job.expansion_type == 's') { //Single line, no expansion
+        job.java_identifier.push_back(job.base_java_identifier); //Use same system for single identifier to be as easy as possible
+        job.bedrock_identifier.push_back(job.base_bedrock_identifier);
+        return 0;
+    }
+    if (job.expansion_type == 'p') { //Pattern, matched against every en_us key
+        if (en_us_keys.empty() && readJavaKeys("lang_java/en_us.json", en_us_keys) != 0) {
+            std::cerr << "Aborted. Failed to read lang_java/en_us.json." << std::endl;
+            return -3;
+        }
+        return expandPattern(job, en_us_keys);
+    }
+
+    //Multiple or colors expansions
+    std::vector<std::string> java_multiple, bedrock_multiple;
+    std::string config_file = "multiple.txt";
+    if (job.expansion_type == 'c') {
+        config_file = "colors_classic.txt";
+    }
+    else if (job.expansion_type == 'n'){
+        config_file = "colors_new.txt";
+    }
+    if (readConfigFile(config_file, java_multiple, bedrock_multiple) != 0) {
+        std::cerr << "Aborted. Failed to read " << config_file << "." << std::endl;
+        return -3;
+    }
+    if (expandIdentifier(job.base_java_identifier, job.java_identifier, java_multiple) != 0) {
+        std::cerr << "Failed to expand list of Java identifiers." << std::endl;
+        return -4;
+    }
+    if (expandIdentifier(job.base_bedrock_identifier, job.bedrock_identifier, bedrock_multiple) != 0) {
+        std::cerr << "Failed to expand list of Bedrock identifiers." << std::endl;
+        return -5;
+    }
+
+    return 0;
+}
+
+//Reads a batch job file, one "<s/m/c/n/p> <java_identifier> <bedrock_identifier> <prefix> <suffix> <sort_override>" job per line
+int readJobFile(const std::string& input_filename,std::vector<PortJob> &jobs) {
+
+    //Open job file
+    std::ifstream fin(input_filename);
+    if (fin.fail()) {
+        std::cerr << "Failed to open " << input_filename << "." << std::endl;
+        return -1;
+    }
+    std::cout << "Opened " << input_filename << "..." << std::endl;
+
+    std::string current_line, input;
+    int line_number = 0;
+    while (getline(fin, current_line, '\n')) {
+        line_number++;
+
+        //Split line into arguments, skipping blank lines and # comments
+        std::istringstream line_stream(current_line);
+        std::vector<std::string> arguments;
+        while (line_stream >> input) {
+            arguments.push_back(input);
+        }
+        if (arguments.empty() || arguments.at(0).at(0) == '#') {
+            continue;
+        }
+
+        std::cout << "Job " << jobs.size() + 1 << " (line " << line_number << ")" << std::endl;
+        jobs.emplace_back();
+        if (parseJob(arguments, jobs.back()) != 0) {
+            std::cerr << "Invalid job on line " << line_number << " of " << input_filename << "." << std::endl;
+            return -2;
+        }
+    }
+    fin.close();
+    std::cout << "Closed " << input_filename << "..." << std::endl << std::endl;
+
+    //Error checker
+    if (jobs.empty()) {
+        std::cerr << "Job file " << input_filename << " does not contain any jobs." << std::endl;
+        return -3;
+    }
+
+    return 0;
+}
+
+//Builds one job porting every en_us definition added or changed since an older release of the Java files
+//Bedrock identifiers come from key_map_file in languages.txt format; definitions missing from it are skipped
+int readReleaseDiff(const std::string &old_directory,const std::string &key_map_file,PortJob &job) {
+
+    std::vector<std::string> changed_keys;
+    int diff_result = diffJavaFiles(old_directory + "/en_us.json", "lang_java/en_us.json", changed_keys, std::cout, std::cerr);
+    if (diff_result != 0) {
+        return diff_result;
+    }
+
+    std::unordered_map<std::string, std::string> key_map;
+    std::vector<std::string> java_keys, bedrock_keys;
+    if (readConfigFile(key_map_file, java_keys, bedrock_keys) != 0) {
+        std::cerr << "Aborted. Failed to read " << key_map_file << "." << std::endl;
+        return -3;
+    }
+    for (size_t i = 0; i < java_keys.size(); i++) {
+        key_map.emplace(java_keys.at(i), bedrock_keys.at(i));
+    }
+
+    //Identifiers are already expanded, and each line is placed by its own identifier
+    job.expansion_type = 'd';
+    size_t unmapped_count = 0;
+    for (const auto & key : changed_keys) {
+        auto bedrock_key = key_map.find(key);
+        if (bedrock_key == key_map.end()) {
+            unmapped_count++;
+            continue;
+        }
+        job.java_identifier.push_back(key);
+        job.bedrock_identifier.push_back(bedrock_key->second);
+    }
+    if (unmapped_count > 0) {
+        std::cerr << "Skipped " << unmapped_count << " definitions with no Bedrock identifier in " << key_map_file << "." << std::endl;
+    }
+    std::cout << "Porting " << job.java_identifier.size() << " added or changed definitions." << std::endl << std::endl;
+
+    return 0;
+}
+
+//Lists the keys of new_path whose string values are missing from old_path or differ from it, in key order
+//Both files are read whole, sorted by key and walked together
+int diffJavaFiles(const std::string &old_path,const std::string &new_path,std::vector<std::string> &changed_keys,std::ostream &out,std::ostream &err) {
+
+    MappedFile old_file, new_file;
+    std::vector<std::pair<std::string, JavaValue>> old_values, new_values;
+    for (auto [path, file, values] : {std::make_tuple(&old_path, &old_file, &old_values), std::make_tuple(&new_path, &new_file, &new_values)}) {
+        if (!file->open(*path)) {
+            err << "Failed to open " + *path + "." << std::endl;
+            return -6;
+        }
+        if (!collectJavaStrings(file->view(), *values)) {
+            err << "Failed to parse " + *path + "." << std::endl;
+            return -12;
+        }
+    }
+
+    //Values are compared unescaped only when either one has escapes
+    auto same_value = [](const JavaValue &a,const JavaValue &b) {
+        if (!a.escaped && !b.escaped) {
+            return a.text == b.text;
+        }
+        std::string a_text, b_text;
+        appendUnescaped(a.text, a_text);
+        appendUnescaped(b.text, b_text);
+        return a_text == b_text;
+    };
+    size_t added_count = 0, changed_count = 0, removed_count = 0;
+    auto old_value = old_values.begin();
+    for (const auto & new_value : new_values) {
+        while (old_value != old_values.end() && old_value->first < new_value.first) {
+            removed_count++;
+            old_value++;
+        }
+        if (old_value == old_values.end() || old_value->first != new_value.first) {
+            added_count++;
+            changed_keys.push_back(new_value.first);
+        }
+        else {
+            if (!same_value(old_value->second, new_value.second)) {
+                changed_count++;
+                changed_keys.push_back(new_value.first);
+            }
+            old_value++;
+        }
+    }
+    removed_count += old_values.end() - old_value;
+    out << "Compared " + old_path + " with " + new_path + ": " << added_count << " added, " << changed_count << " changed, " << removed_count << " removed." << std::endl;
+
+    return 0;
+}
+
+//Scans every string definition of a Java file into values, sorted by key
+//The last value of a repeated key wins, as with json::parse, and a key whose last value is not a string has no definition
+bool collectJavaStrings(std::string_view text,std::vector<std::pair<std::string, JavaValue>> &values) {
+
+    std::vector<std::pair<std::string, std::optional<JavaValue>>> members;
+    bool parsed = scanJsonStrings(text, [&](std::string_view key,std::string_view value,bool escaped) {
+        members.emplace_back(std::string(key), JavaValue{value, escaped});
+        return true;
+    }, [&](std::string_view key) {
+        members.emplace_back(std::string(key), std::nullopt);
+        return true;
+    });
+    if (!parsed) {
+        return false;
+    }
+    std::stable_sort(members.begin(), members.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+    values.reserve(members.size());
+    for (size_t m = 0; m < members.size(); m++) {
+        bool replaced = m + 1 < members.size() && members.at(m + 1).first == members.at(m).first;
+        if (!replaced && members.at(m).second) {
+            values.emplace_back(std::move(members.at(m).first), *members.at(m).second);
+        }
+    }
+
+    return true;
+}
+
+//Suggests Bedrock identifiers for Java identifiers by matching their English definitions, and writes the pairs to map_path
+//Pairs are written in languages.txt format, one per line, for a release diff key map; text shared by several Bedrock lines is left out
+int deriveKeyMap(const std::string &java_path,const std::string &bedrock_path,const std::string &map_path) {
+
+    MappedFile java_file, bedrock_file;
+    if (!java_file.open(java_path)) {
+        std::cerr << "Failed to open " << java_path << "." << std::endl;
+        return -6;
+    }
+    if (!bedrock_file.open(bedrock_path)) {
+        std::cerr << "Failed to open " << bedrock_path << "." << std::endl;
+        return -9;
+    }
+
+    //Bedrock identifier by definition; an empty identifier marks text defined more than once
+    std::string_view bedrock_text = bedrock_file.view();
+    std::vector<LangToken> tokens;
+    tokenizeLang(bedrock_text, tokens);
+    std::unordered_map<std::string_view, std::string_view> bedrock_keys;
+    bedrock_keys.reserve(tokens.size());
+    for (const auto & token : tokens) {
+        if (!token.hasValue() || token.key_size == 0 || bedrock_text.at(token.begin) == '#') {
+            continue;
+        }
+        std::string_view value = bedrock_text.substr(token.begin + token.key_size + 1, token.size - token.key_size - 1);
+        value = value.substr(0, value.find("\t#")); //Comments after the definition
+        while (!value.empty() && (value.back() == '\r' || value.back() == '\t' || value.back() == ' ')) {
+            value.remove_suffix(1);
+        }
+        if (value.empty()) {
+            continue;
+        }
+        std::string_view key = bedrock_text.substr(token.begin, token.key_size);
+        auto found = bedrock_keys.emplace(value, key);
+        if (!found.second && found.first->second != key) {
+            found.first->second = std::string_view();
+        }
+    }
+
+    //Join each Java definition on its text; definitions come sorted by key, so the pairs are too
+    std::vector<std::pair<std::string, JavaValue>> java_values;
+    if (!collectJavaStrings(java_file.view(), java_values)) {
+        std::cerr << "Failed to parse " << java_path << "." << std::endl;
+        return -12;
+    }
+    std::vector<std::pair<std::string_view, std::string_view>> pairs;
+    size_t ambiguous_count = 0, java_count = java_values.size();
+    std::string java_value;
+    for (const auto & [key, value] : java_values) {
+        std::string_view text = value.text;
+        if (value.escaped) {
+            java_value.clear();
+            appendUnescaped(value.text, java_value);
+            text = java_value;
+        }
+        auto bedrock_key = bedrock_keys.find(text);
+        if (bedrock_key != bedrock_keys.end()) {
+            if (bedrock_key->second.empty()) {
+                ambiguous_count++;
+            }
+            else {
+                pairs.emplace_back(key, bedrock_key->second);
+            }
+        }
+    }
+
+    std::ofstream fout(map_path);
+    for (size_t p = 0; p < pairs.size(); p++) {
+        fout << pairs.at(p).first << " " << pairs.at(p).second << "\n"; //Ends with a newline, so hand-written pairs can be added below
+    }
+    fout.close();
+    if (fout.fail()) {
+        std::cerr << "Failed to write " << map_path << "." << std::endl;
+        return -10;
+    }
+    std::cout << "Matched " << pairs.size() << " of " << java_count << " Java definitions to Bedrock identifiers; wrote " << map_path << "." << std::endl;
+    if (ambiguous_count > 0) {
+        std::cout << "Left out " << ambiguous_count << " Java definitions whose text matches more than one Bedrock identifier." << std::endl;
+    }
+
+    return 0;
+}
+
+//Runs task once per language, on thread_count workers at once
+//With more than one worker, each language's messages are buffered and printed in language order
+//Workers start the largest languages first, by language_bytes, and steal queued languages from each other once idle
+int runLanguages(size_t language_count,int thread_count,const std::vector<uint64_t> &language_bytes,Profiler *profiler,const std::function<int(size_t,std::ostream&,std::ostream&)> &task) {
+
+    //Sequential, printing straight to the console and stopping at the first failure
+    if (thread_count <= 1 || language_count <= 1) {
+        for (size_t i = 0; i < language_count; i++) {
+            int result = task(i, std::cout, std::cerr);
+            if (result != 0) {
+                return result;
+            }
+        }
+        return 0;
+    }
+
+    std::vector<std::ostringstream> out_logs(language_count), err_logs(language_count);
+    std::vector<int> results(language_count, 0);
+    std::vector<bool> finished(language_count, false);
+    std::atomic<size_t> first_failure{language_count}; //Languages after it in languages.txt are not started
+    std::mutex print_mutex;
+    size_t next_print = 0;
+
+    //Deal languages largest first, round robin, so every worker starts with one of the largest files
+    size_t worker_count = std::min<size_t>(thread_count, language_count);
+    std::vector<size_t> language_order(language_count);
+    for (size_t i = 0; i < language_count; i++) {
+        language_order.at(i) = i;
+    }
+    std::stable_sort(language_order.begin(), language_order.end(), [&](size_t a, size_t b) {
+        return language_bytes.at(a) > language_bytes.at(b);
+    });
+    std::vector<std::deque<size_t>> queues(worker_count);
+    std::vector<uint64_t> queued_bytes(worker_count, 0);
+    for (size_t o = 0; o < language_count; o++) {
+        queues.at(o % worker_count).push_back(language_order.at(o));
+        queued_bytes.at(o % worker_count) += language_bytes.at(language_order.at(o));
+    }
+    std::mutex queue_mutex;
+
+    //Takes the worker's own largest language, or the smallest language of the worker with the most bytes left
+    auto next_language = [&](size_t worker, size_t &language, bool &stolen) {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        size_t victim = worker;
+        if (queues.at(worker).empty()) {
+            victim = std::max_element(queued_bytes.begin(), queued_bytes.end()) - queued_bytes.begin();
+            if (queues.at(victim).empty()) {
+                return false;
+            }
+        }
+        stolen = victim != worker;
+        if (stolen) {
+            language = queues.at(victim).back();
+            queues.at(victim).pop_back();
+        }
+        else {
+            language = queues.at(victim).front();
+            queues.at(victim).pop_front();
+        }
+        queued_bytes.at(victim) -= language_bytes.at(language);
+        return true;
+    };
+
+    //Prints every finished language that is next in order; caller holds print_mutex
+    auto print_finished = [&]() {
+        while (next_print < language_count && finished.at(next_print)) {
+            std::cout << out_logs.at(next_print).str() << std::flush;
+            std::cerr << err_logs.at(next_print).str() << std::flush;
+            out_logs.at(next_print).str("");
+            err_logs.at(next_print).str("");
+            next_print++;
+        }
+    };
+
+    //Workers run languages until every queue is empty, skipping languages after a failure
+    auto worker = [&](size_t w) {
+        WorkerRecord worker_record;
+        worker_record.worker = w + 1;
+        auto start = std::chrono::steady_clock::now();
+        size_t i;
+        bool stolen;
+        while (next_language(w, i, stolen)) {
+            if (i > first_failure) {
+                continue;
+            }
+            auto task_start = std::chrono::steady_clock::now();
+            int result = task(i, out_logs.at(i), err_logs.at(i));
+            worker_record.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - task_start).count();
+            worker_record.languages++;
+            worker_record.steals += stolen ? 1 : 0;
+            worker_record.bytes += language_bytes.at(i);
+
+            std::lock_guard<std::mutex> lock(print_mutex);
+            results.at(i) = result;
+            finished.at(i) = true;
+            if (result != 0 && i < first_failure) {
+                first_failure = i;
+            }
+            print_finished();
+        }
+        worker_record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (profiler != nullptr) {
+            profiler->recordWorker(worker_record);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t w = 0; w < worker_count; w++) {
+        workers.emplace_back(worker, w);
+    }
+    for (auto & t : workers) {
+        t.join();
+    }
+
+    //After a failure, languages that were never started leave gaps; print whatever finished
+    for (size_t i = next_print; i < language_count; i++) {
+        if (finished.at(i)) {
+            std::cout << out_logs.at(i).str() << std::flush;
+            std::cerr << err_logs.at(i).str() << std::flush;
+        }
+    }
+
+    //Report the first failure in language order
+    for (int result : results) {
+        if (result != 0) {
+            return result;
+        }
+    }
+    return 0;
+}
+
+//Bytes a language pair reads, for scheduling the largest languages first; missing files count as empty
+uint64_t languageBytes(const std::string &java_language,const std::string &bedrock_language,const RunOptions &options) {
+
+    std::error_code size_error;
+    std::string java_path = "lang_java/" + java_language + ".json";
+    std::string cache_path = ".cache/" + java_language + ".tpbin";
+    if (options.use_cache && std::filesystem::exists(cache_path, size_error)) {
+        java_path = cache_path;
+    }
+    uint64_t bytes = 0;
+    for (const auto & path : {java_path, "lang_bedrock/" + bedrock_language + ".lang"}) {
+        uint64_t file_bytes = std::filesystem::file_size(path, size_error);
+        bytes += size_error ? 0 : file_bytes;
+    }
+    return bytes;
+}
+
+//Ports every job into one Java/Bedrock language pair
+int portLanguage(const std::string &java_language,const std::string &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,PortManifest *manifest,std::ostream &out,std::ostream &err) {
+
+    if (manifest != nullptr && manifest->unchanged(java_language, bedrock_language)) {
+        reportUnchanged(java_language, bedrock_language, out);
+        return 0;
+    }
+    LangFile lang_file;
+    int prepare_result = prepareLanguage(java_language, bedrock_language, jobs, options, profiler, lang_file, out, err);
+    if (prepare_result != 0) {
+        return prepare_result;
+    }
+    int commit_result = commitLanguage(java_language, bedrock_language, lang_file, profiler, out, err);
+    if (manifest != nullptr && commit_result == 0) {
+        manifest->record(java_language, bedrock_language);
+    }
+    return commit_result;
+}
+
+void reportUnchanged(const std::string &java_language,const std::string &bedrock_language,std::ostream &out) {
+    out << "Skipped " + bedrock_language + ".lang; it and " + java_language + ".json are unchanged since they were last ported with these jobs." << std::endl << std::endl;
+}
+
+//Identifies everything besides the language files that decides a port's output, for the manifest
+uint64_t hashJobs(const std::vector<PortJob> &jobs,const RunOptions &options) {
+
+    //Fields are ended with a byte no field holds, so moving text between fields changes the hash
+    std::string fields = options.placement + '\0' + options.on_conflict + '\0';
+    for (const auto & job : jobs) {
+        fields += std::string(1, job.expansion_type) + '\0' + job.prefix + '\0' + job.suffix + '\0' + (job.sort_override_enabled ? job.sort_override : std::string("NULL")) + '\0';
+        for (size_t i = 0; i < job.java_identifier.size(); i++) {
+            fields += job.java_identifier.at(i) + '\0' + (i < job.bedrock_identifier.size() ? job.bedrock_identifier.at(i) : std::string()) + '\0';
+        }
+        fields += '\n';
+    }
+    return hashText(fields);
+}
+
+//Reads one language pair's definitions and merges them into its Bedrock lines, without writing anything
+int prepareLanguage(const std::string &java_language,const std::string &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,LangFile &lang_file,std::ostream &out,std::ostream &err) {
+
+    std::string language_pair = java_language + "/" + bedrock_language;
+    std::error_code size_error;
+
+//////
+//////  READ JAVA DEFINITIONS
+//////
+
+    Profiler::Phase java_phase(profiler, language_pair, "java read");
+    std::vector<std::vector<std::string>> definitions; //One list of definitions per job
+    uint64_t java_bytes_read = 0;
+    int read_result = readJavaDefinitions(java_language, jobs, options, definitions, java_bytes_read, out, err);
+    if (read_result != 0) {
+        return read_result;
+    }
+    java_phase.addRead(java_bytes_read);
+    java_phase.finish();
+
+//////
+//////  MERGE BEDROCK DEFINITIONS
+//////
+
+    Profiler::Phase merge_phase(profiler, language_pair, "bedrock merge");
+    if (profiler != nullptr) {
+        merge_phase.addRead(std::filesystem::file_size("lang_bedrock/" + bedrock_language + ".lang", size_error));
+    }
+    return mergeBedrockDefinitions(bedrock_language, jobs, definitions, options, lang_file, out, err);
+}
+
+//Writes one language pair's merged Bedrock lines over the original file
+int commitLanguage(const std::string &java_language,const std::string &bedrock_language,LangFile &lang_file,Profiler *profiler,std::ostream &out,std::ostream &err) {
+
+    std::error_code size_error;
+    Profiler::Phase write_phase(profiler, java_language + "/" + bedrock_language, "bedrock write");
+    int write_result = commitLangFile(bedrock_language, lang_file, out, err);
+    if (profiler != nullptr && write_result == 0) {
+        write_phase.addWritten(std::filesystem::file_size("lang_bedrock/" + bedrock_language + ".lang", size_error));
+    }
+    return write_result;
+}
+
+//Reads one language pair's files into the page cache, so the next stage finds them in memory
+//Failures are left for the next stage to report
+void prefetchLanguage(const std::string &java_language,const std::string &bedrock_language,const RunOptions &options,Profiler *profiler) {
+
+    Profiler::Phase prefetch_phase(profiler, java_language + "/" + bedrock_language, "prefetch");
+    std::string java_path = "lang_java/" + java_language + ".json";
+    std::string cache_path = ".cache/" + java_language + ".tpbin";
+    std::error_code exists_error;
+    if (options.use_cache && std::filesystem::exists(cache_path, exists_error)) {
+        java_path = cache_path;
+    }
+    for (const auto & path : {java_path, "lang_bedrock/" + bedrock_language + ".lang"}) {
+        MappedFile file;
+        if (file.open(path)) {
+            file.prefetch();
+            prefetch_phase.addRead(file.size());
+        }
+    }
+}
+
+//One language on its way from the merge stage to the write stage
+struct LanguagePort {
+    size_t language = 0;
+    int result = 0;
+    LangFile lang_file;
+    std::ostringstream out, err;
+};
+
+//Ports every language through three stages at once: prefetching files, merging definitions, and writing
+//Languages move through the stages in order, so messages print and failures stop the run as in a sequential run
+int runPipeline(const std::vector<std::string> &java_language,const std::vector<std::string> &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,PortManifest *manifest) {
+
+    size_t language_count = bedrock_language.size();
+    std::vector<char> unchanged(language_count, 0); //Set by the reader before the language is queued
+    BoundedQueue<size_t> merge_queue(options.pipeline_depth); //Prefetched languages
+    BoundedQueue<std::unique_ptr<LanguagePort>> write_queue(options.pipeline_depth); //Merged languages
+    std::atomic<bool> failed{false};
+
+    std::thread reader([&]() {
+        for (size_t i = 0; i < language_count && !failed; i++) {
+            unchanged.at(i) = manifest != nullptr && manifest->unchanged(java_language.at(i), bedrock_language.at(i));
+            if (!unchanged.at(i)) {
+                prefetchLanguage(java_language.at(i), bedrock_language.at(i), options, profiler);
+            }
+            if (!merge_queue.push(i)) {
+                break;
+            }
+        }
+        merge_queue.close();
+    });
+    std::thread merger([&]() {
+        size_t i;
+        while (merge_queue.pop(i)) {
+            auto port = std::make_unique<LanguagePort>();
+            port->language = i;
+            if (unchanged.at(i)) {
+                reportUnchanged(java_language.at(i), bedrock_language.at(i), port->out);
+            }
+            else if (!failed) {
+                port->result = prepareLanguage(java_language.at(i), bedrock_language.at(i), jobs, options, profiler, port->lang_file, port->out, port->err);
+            }
+            if (!write_queue.push(std::move(port))) {
+                break;
+            }
+        }
+        write_queue.close();
+    });
+
+    //Writing stays on this thread; nothing after a failed language is written or printed
+    int result = 0;
+    std::unique_ptr<LanguagePort> port;
+    while (write_queue.pop(port)) {
+        if (result != 0) {
+            continue;
+        }
+        size_t i = port->language;
+        if (port->result == 0 && !unchanged.at(i)) {
+            port->result = commitLanguage(java_language.at(i), bedrock_language.at(i), port->lang_file, profiler, port->out, port->err);
+            if (manifest != nullptr && port->result == 0) {
+                manifest->record(java_language.at(i), bedrock_language.at(i));
+            }
+        }
+        std::cout << port->out.str() << std::flush;
+        std::cerr << port->err.str() << std::flush;
+        result = port->result;
+        if (result != 0) {
+            failed = true;
+            merge_queue.close();
+            write_queue.close();
+        }
+    }
+    reader.join();
+    merger.join();
+
+    return result;
+}
+
+//Parses one Java language file and reads every job's definitions into definitions, one list per job
+int readJavaDefinitions(const std::string &java_language,const std::vector<PortJob> &jobs,const RunOptions &options,std::vector<std::vector<std::string>> &definitions,uint64_t &bytes_read,std::ostream &out,std::ostream &err) {
+
+    //Every identifier needed by any job
+    std::unordered_set<std::string> wanted_identifiers;
+    for (const auto & job : jobs) {
+        wanted_identifiers.insert(job.java_identifier.begin(), job.java_identifier.end());
+    }
+
+    JavaValues java_values;
+    int load_result = loadJavaValues(java_language, wanted_identifiers, options, java_values, out, err);
+    bytes_read = java_values.bytes_read;
+    if (load_result != 0) {
+        return load_result;
+    }
+    return buildDefinitions(java_language, jobs, java_values, definitions, out, err);
+}
+
+//Reads the values of the wanted identifiers from one Java language file into java_values
+int loadJavaValues(const std::string &java_language,const std::unordered_set<std::string> &wanted_identifiers,const RunOptions &options,JavaValues &java_values,std::ostream &out,std::ostream &err) {
+
+    //A valid cache answers without reading the source at all
+    if (options.use_cache) {
+        return readCachedJavaValues(java_language, wanted_identifiers, java_values, out, err);
+    }
+
+    //The JSON is parsed straight out of the mapping, same as the .lang files, and the mapping stays open for the values
+    if (!java_values.mapping.open("lang_java/" + java_language + ".json")) {
+        err << "Failed to open lang_java/" + java_language + ".json." << std::endl;
+        return -6;
+    }
+    out << "Opened " + java_language + ".json..." << std::endl;
+    java_values.bytes_read = java_values.mapping.size();
+    std::string_view java_text = java_values.mapping.view();
+
+    //Read only the needed values; the full document is only built when asked for
+    if (options.java_reader == "raw") {
+        //Values stay where they are in the mapping; only ones with escapes are ever unescaped, when definitions are built
+        std::unordered_set<std::string_view> wanted_keys(wanted_identifiers.begin(), wanted_identifiers.end());
+        //The last value of a repeated key wins, as with json::parse, so the whole file is always scanned
+        bool parsed = scanJsonStrings(java_text, [&](std::string_view key,std::string_view value,bool escaped) {
+            if (wanted_keys.count(key) != 0) {
+                java_values.values.insert_or_assign(std::string(key), JavaValue{value, escaped});
+            }
+            return true;
+        }, [&](std::string_view key) {
+            if (wanted_keys.count(key) != 0) {
+                java_values.values.erase(std::string(key)); //A value that is not a string is not a definition
+            }
+            return true;
+        });
+        if (!parsed) {
+            err << "Failed to parse lang_java/" + java_language + ".json." << std::endl;
+            return -12;
+        }
+        return 0;
+    }
+    if (options.java_reader == "dom") {
+        //Every node of the document comes from one arena, released in one piece when this language is done
+        MonotonicArena arena(java_text.size() * 2);
+        arena_json *java_json = parseArenaJson(arena, java_text.begin(), java_text.end());
+        if (java_json == nullptr) {
+            err << "Failed to parse lang_java/" + java_language + ".json." << std::endl;
+            return -12;
+        }
+        const arena_json::object_t *java_object = java_json->get_ptr<const arena_json::object_t *>();
+        for (const auto & j : wanted_identifiers) {
+            const arena_json *java_value = java_object != nullptr ? java_object->findValue(j) : nullptr;
+            const arena_string *value = java_value != nullptr ? java_value->get_ptr<const arena_string *>() : nullptr;
+            if (value != nullptr) {
+                keepParsedValue(java_values, j, std::string(value->data(), value->size()));
+            }
+        }
+        return 0;
+    }
+    std::unordered_map<std::string, std::string> parsed_values;
+    SelectiveExtractor extractor(&wanted_identifiers, parsed_values);
+    if (!json::sax_parse(java_text.begin(), java_text.end(), &extractor)) {
+        err << "Failed to parse lang_java/" + java_language + ".json." << std::endl;
+        return -12;
+    }
+    for (auto & parsed_value : parsed_values) {
+        keepParsedValue(java_values, parsed_value.first, std::move(parsed_value.second));
+    }
+    return 0;
+}
+
+//Stores a value that a reader had to copy out of the file, for java_values to point to
+void keepParsedValue(JavaValues &java_values,const std::string &identifier,std::string value) {
+    java_values.parsed_values.push_back(std::move(value));
+    java_values.values.emplace(identifier, JavaValue{java_values.parsed_values.back(), false});
+}
+
+//Builds every job's definitions from the loaded Java values, adding the job's prefix and suffix
+int buildDefinitions(const std::string &java_language,const std::vector<PortJob> &jobs,const JavaValues &java_values,std::vector<std::vector<std::string>> &definitions,std::ostream &out,std::ostream &err) {
+
+    //Read all necessary defs, store in vector
+    std::vector<bool> identifier_found(jobs.size(), false); //For error checking
+    for (size_t i = 0; i < jobs.size(); i++) {
+        std::vector<std::string> definition;
+        definition.reserve(jobs.at(i).java_identifier.size());
+        for (const auto & j : jobs.at(i).java_identifier) {
+            auto java_value = java_values.values.find(j);
+            if (java_value != java_values.values.end()) {
+                //Prefix, value and suffix are written once into a string of the final size
+                const JavaValue &value = java_value->second;
+                std::string &current_string = definition.emplace_back();
+                current_string.reserve(jobs.at(i).prefix.size() + value.text.size() + jobs.at(i).suffix.size());
+                current_string += jobs.at(i).prefix;
+                if (value.escaped) {
+                    appendUnescaped(value.text, current_string);
+                }
+                else {
+                    current_string += value.text;
+                }
+                current_string += jobs.at(i).suffix;
+                identifier_found.at(i) = true;
+            }
+            else {
+                err << "Failed to find " << j << " in " << java_language << ".json." << std::endl;
+                definition.emplace_back("NULL");
+            }
+        }
+        definitions.push_back(std::move(definition));
+    }
+    out << "Finished reading " + java_language + ".json..." << std::endl;
+
+    for (size_t i = 0; i < jobs.size(); i++) {
+        //Check any identifier was found in file
+        if (!identifier_found.at(i)) {
+            err << "Aborted; no matching definitions found." << std::endl;
+            return -7;
+        }
+
+        //Check for size error
+        if (jobs.at(i).java_identifier.size() != definitions.at(i).size()) {
+            err << "Aborted; Java identifiers and definitions desynchronized." << std::endl;
+            return -8;
+        }
+    }
+
+    return 0;
+}
+
+//Looks up the wanted definitions in the language's compiled cache, rebuilding it from the source file when that changed
+int readCachedJavaValues(const std::string &java_language,const std::unordered_set<std::string> &wanted_identifiers,JavaValues &java_values,std::ostream &out,std::ostream &err) {
+
+    std::string source_path = "lang_java/" + java_language + ".json";
+    std::string cache_path = ".cache/" + java_language + ".tpbin";
+    JavaCache &cache = java_values.cache;
+    if (!cache.open(cache_path, source_path)) {
+        if (!java_values.mapping.open(source_path)) {
+            err << "Failed to open " + source_path + "." << std::endl;
+            return -6;
+        }
+        out << "Opened " + java_language + ".json..." << std::endl;
+        java_values.bytes_read = java_values.mapping.size();
+        std::string_view java_text = java_values.mapping.view();
+
+        //The cache needs every definition, so the whole file is read once
+        std::unordered_map<std::string, std::string> all_values;
+        SelectiveExtractor extractor(nullptr, all_values);
+        if (!json::sax_parse(java_text.begin(), java_text.end(), &extractor)) {
+            err << "Failed to parse " + source_path + "." << std::endl;
+            return -12;
+        }
+        if (!JavaCache::build(cache_path, source_path, std::vector<std::pair<std::string, std::string>>(all_values.begin(), all_values.end())) || !cache.open(cache_path, source_path)) {
+            err << "Failed to write " + cache_path + "; reading " + source_path + " without a cache." << std::endl;
+            for (const auto & j : wanted_identifiers) {
+                auto java_value = all_values.find(j);
+                if (java_value != all_values.end()) {
+                    keepParsedValue(java_values, j, std::move(java_value->second));
+                }
+            }
+            return 0;
+        }
+        out << "Compiled " + cache_path + "..." << std::endl;
+    }
+    else {
+        java_values.bytes_read = cache.fileSize();
+    }
+
+    for (const auto & j : wanted_identifiers) {
+        std::optional<std::string_view> java_value = cache.find(j);
+        if (java_value) {
+            java_values.values.emplace(j, JavaValue{*java_value, false}); //Points into the mapped cache
+        }
+    }
+    return 0;
+}
+
+//Reads one Bedrock language file and inserts every job's definitions into its pieces, without writing
+int mergeBedrockDefinitions(const std::string &bedrock_language,const std::vector<PortJob> &jobs,const std::vector<std::vector<std::string>> &definitions,const RunOptions &options,LangFile &lang_file,std::ostream &out,std::ostream &err) {
+
+    int read_result = readLangFile(bedrock_language, jobs, lang_file, out, err);
+    if (read_result != 0) {
+        return read_result;
+    }
+
+    //Each job is inserted into the result of the previous one, as if run one after another
+    for (size_t j = 0; j < jobs.size(); j++) {
+        int insert_result = insertDefinitions(lang_file, bedrock_language, jobs.at(j), definitions.at(j), options, err);
+        if (insert_result != 0) {
+            return insert_result;
+        }
+    }
+
+    return 0;
+}
+
+//Maps one Bedrock language file and splits it into lines, noting existing definitions of any job's keys
+int readLangFile(const std::string &bedrock_language,const std::vector<PortJob> &jobs,LangFile &lang_file,std::ostream &out,std::ostream &err) {
+
+    //Append output definitions
+    if (!lang_file.mapping.open("lang_bedrock/" + bedrock_language + ".lang")) {
+        err << "Failed to open lang_bedrock/" + bedrock_language + ".lang." << std::endl;
+        return -9;
+    }
+    out << "Opened existing " + bedrock_language + ".lang..." << std::endl;
+
+    //Every Bedrock key any job will add, for finding existing definitions while splitting lines
+    std::unordered_set<std::string_view> requested_keys;
+    for (const auto & job : jobs) {
+        requested_keys.insert(job.bedrock_identifier.begin(), job.bedrock_identifier.end());
+    }
+
+    //Lines as split by getline; the last entry is empty when the file ends with a newline
+    //Newlines and each line's first '=' are found in the same pass
+    std::string_view file_text = lang_file.mapping.view();
+    std::vector<LangToken> tokens;
+    tokenizeLang(file_text, tokens);
+    lang_file.lines.reserve(tokens.size());
+    for (const auto & token : tokens) {
+        std::string_view current_line = file_text.substr(token.begin, token.size);
+        if (!current_line.empty() && current_line.back() == '\r') { //Windows line endings are kept when writing
+            current_line.remove_suffix(1);
+            lang_file.line_ending = "\r\n";
+        }
+        lang_file.lines.push_back(current_line);
+        std::string_view current_key = current_line.substr(0, token.key_size);
+        if (requested_keys.count(current_key) != 0) {
+            lang_file.existing_definitions.emplace_back(current_key, lang_file.lines.size());
+        }
+    }
+    indexLangFile(lang_file);
+    lang_file.pieces.push_back({0, lang_file.lines.size(), {}});
+
+    return 0;
+}
+
+//Writes the finished lines of a Bedrock file over the original and releases its mapping
+int commitLangFile(const std::string &bedrock_language,LangFile &lang_file,std::ostream &out,std::ostream &err) {
+
+    //Insert output definitions through a temporary file, since the lines point into the mapped original
+    std::string lang_path = "lang_bedrock/" + bedrock_language + ".lang";
+    std::string temp_path = lang_path + "." + std::to_string(currentProcessId()) + ".tmp"; //Sibling file, so the rename cannot cross file systems
+    bool written = writeFileRanges(temp_path, buildOutputRanges(lang_file));
+    lang_file.mapping.close();
+    if (!written) {
+        err << "Failed to write " + temp_path + "." << std::endl;
+        std::remove(temp_path.c_str());
+        return -10;
+    }
+    if (!replaceFile(temp_path, lang_path)) {
+        err << "Failed to replace " + lang_path + "." << std::endl;
+        std::remove(temp_path.c_str());
+        return -10;
+    }
+    out << "Overwrote " + bedrock_language + ".lang..." << std::endl;
+    out << "Finished writing to " + bedrock_language + ".lang..." << std::endl << std::endl;
+
+    return 0;
+}
+
+//Splits the output into as few byte ranges as possible; runs of unchanged lines become one range of the mapped file
+std::vector<std::string_view> buildOutputRanges(const LangFile &lang_file) {
+
+    std::string_view file_text = lang_file.mapping.view();
+    std::string_view line_ending = lang_file.line_ending;
+    std::vector<std::string_view> ranges;
+    const char *range_start = nullptr;
+    size_t range_size = 0;
+
+    //Ends the current range and starts a new one at text
+    auto start_range = [&](const char *text) {
+        if (range_size > 0) {
+            ranges.emplace_back(range_start, range_size);
+        }
+        range_start = text;
+        range_size = 0;
+    };
+
+    //Merge the original lines with the added ones in a single pass
+    size_t line_count = 0, lines_written = 0;
+    for (const auto & piece : lang_file.pieces) {
+        line_count += pieceSize(piece);
+    }
+    for (const auto & piece : lang_file.pieces) {
+        for (size_t p = 0; p < pieceSize(piece); p++) {
+            std::string_view line = pieceLine(lang_file, piece, p);
+            bool last_line = ++lines_written == line_count; //Final empty entry is the end of the file
+            if (line.empty() && last_line) {
+                break;
+            }
+
+            //Lines continue the current range when they directly follow it
+            if (range_size == 0 || line.data() != range_start + range_size) {
+                start_range(line.data());
+            }
+            range_size += line.size();
+            if (last_line) {
+                break;
+            }
+
+            //Keep the original line ending in the range when it matches, otherwise add it separately
+            bool in_file = line.data() >= file_text.data() && line.data() + line.size() <= file_text.data() + file_text.size();
+            if (in_file && file_text.substr(line.data() + line.size() - file_text.data(), line_ending.size()) == line_ending) {
+                range_size += line_ending.size();
+            }
+            else {
+                start_range(line_ending.data());
+                range_size = line_ending.size();
+            }
+        }
+    }
+    start_range(nullptr);
+
+    return ranges;
+}
+
+//Splits the lines of a Bedrock file into blocks separated by blank lines
+void indexLangFile(LangFile &lang_file) {
+
+    const std::vector<std::string_view> &lines = lang_file.lines;
+    lang_file.blocks.clear();
+    for (size_t l = 0; l < lines.size(); l++) {
+        if (lines.at(l).empty()) {
+            continue;
+        }
+        if (lang_file.blocks.empty() || lang_file.blocks.back().end != l) {
+            lang_file.blocks.push_back({l, l, true});
+        }
+        LangBlock &block = lang_file.blocks.back();
+        if (block.end > block.begin && lines.at(l) < lines.at(l - 1)) {
+            block.sorted = false;
+        }
+        block.end = l + 1;
+    }
+}
+
+//Returns the first original line in [start, end) starting with prefix, or end when there is none
+size_t findPrefixLine(const LangFile &lang_file,std::string_view prefix,size_t start,size_t end) {
+
+    const std::vector<std::string_view> &lines = lang_file.lines;
+    auto block = std::lower_bound(lang_file.blocks.begin(), lang_file.blocks.end(), start, [](const LangBlock &block, size_t line) {
+        return block.end <= line;
+    });
+    for (; block != lang_file.blocks.end() && block->begin < end; block++) {
+        auto first = lines.begin() + std::max(block->begin, start), last = lines.begin() + std::min(block->end, end);
+        if (block->sorted) { //Lines starting with prefix are the first lines not less than it
+            first = std::lower_bound(first, last, prefix);
+        }
+        else {
+            first = std::find_if(first, last, [&](std::string_view line) {
+                return line.substr(0, prefix.size()) == prefix;
+            });
+        }
+        if (first != last && first->substr(0, prefix.size()) == prefix) {
+            return first - lines.begin();
+        }
+    }
+    return end;
+}
+
+//Returns the first original line in [start, end) not less than identifier, or end when there is none
+size_t findStopLine(const LangFile &lang_file,std::string_view identifier,bool stop_at_blank,size_t start,size_t end) {
+
+    const std::vector<std::string_view> &lines = lang_file.lines;
+    if (identifier.empty()) { //Every line is at least an empty identifier
+        return start;
+    }
+
+    //Start from the block holding start; blank lines only stop the search in sort override
+    auto block = std::lower_bound(lang_file.blocks.begin(), lang_file.blocks.end(), start, [](const LangBlock &block, size_t line) {
+        return block.end <= line;
+    });
+    if (stop_at_blank && (block == lang_file.blocks.end() || block->begin > start)) {
+        return start;
+    }
+    for (; block != lang_file.blocks.end() && block->begin < end; block++) {
+        auto first = lines.begin() + std::max(block->begin, start), last = lines.begin() + std::min(block->end, end);
+        if (block->sorted) {
+            first = std::lower_bound(first, last, identifier);
+        }
+        else {
+            first = std::find_if(first, last, [&](std::string_view line) {
+                return !(line < identifier);
+            });
+        }
+        if (first != last) {
+            return first - lines.begin();
+        }
+        if (stop_at_blank) {
+            return std::min(block->end, end);
+        }
+    }
+    return end;
+}
+
+size_t pieceSize(const LangPiece &piece) {
+    return piece.added.empty() ? piece.end - piece.begin : piece.added.size();
+}
+
+std::string_view pieceLine(const LangFile &lang_file,const LangPiece &piece,size_t offset) {
+    return piece.added.empty() ? lang_file.lines.at(piece.begin + offset) : piece.added.at(offset);
+}
+
+//Returns the first line from start matching in the output, or the end of the pieces when there is none
+//Original ranges are searched through the block index by find_original, added lines one by one with matches
+LangPosition findLine(const LangFile &lang_file,LangPosition start,const std::function<size_t(size_t,size_t)> &find_original,const std::function<bool(std::string_view)> &matches) {
+
+    for (size_t p = start.piece; p < lang_file.pieces.size(); p++) {
+        const LangPiece &piece = lang_file.pieces.at(p);
+        size_t offset = p == start.piece ? start.offset : 0;
+        if (piece.added.empty()) {
+            size_t line = find_original(piece.begin + offset, piece.end);
+            if (line != piece.end) {
+                return {p, line - piece.begin};
+            }
+            continue;
+        }
+        for (; offset < piece.added.size(); offset++) {
+            if (matches(piece.added.at(offset))) {
+                return {p, offset};
+            }
+        }
+    }
+    return {lang_file.pieces.size(), 0};
+}
+
+//Adds new_lines before the line at position, or after everything at the end of the file
+//Trailing blank lines after the new lines are removed, and the result always ends with a newline
+//Returns where the line that was at position is now, or the end of the pieces when inserting at the end
+LangPosition insertLines(LangFile &lang_file,LangPosition position,const std::vector<std::string_view> &new_lines,bool insert_end) {
+
+    std::vector<LangPiece> &pieces = lang_file.pieces;
+
+    //Adds lines to the added piece before index, or a new piece there
+    auto add_before = [&](size_t index, const std::vector<std::string_view> &lines) {
+        if (lines.empty()) {
+            return index;
+        }
+        if (index > 0 && !pieces.at(index - 1).added.empty()) {
+            std::vector<std::string_view> &added = pieces.at(index - 1).added;
+            added.insert(added.end(), lines.begin(), lines.end());
+            return index;
+        }
+        LangPiece piece;
+        piece.added = lines;
+        pieces.insert(pieces.begin() + index, std::move(piece));
+        return index + 1;
+    };
+
+    if (!insert_end) {
+        LangPiece &piece = pieces.at(position.piece);
+        if (!piece.added.empty()) {
+            piece.added.insert(piece.added.begin() + position.offset, new_lines.begin(), new_lines.end());
+            position.offset += new_lines.size();
+        }
+        else {
+            if (position.offset > 0) { //Split the original range at the stop line
+                LangPiece stop_piece;
+                stop_piece.begin = piece.begin + position.offset;
+                stop_piece.end = piece.end;
+                piece.end = stop_piece.begin;
+                pieces.insert(pieces.begin() + ++position.piece, stop_piece);
+                position.offset = 0;
+            }
+            position.piece = add_before(position.piece, new_lines);
+        }
+
+        //Remove trailing whitespace, keeping the stop line
+        while (position.piece + 1 < pieces.size() || position.offset + 1 < pieceSize(pieces.back())) {
+            LangPiece &last_piece = pieces.back();
+            if (!pieceLine(lang_file, last_piece, pieceSize(last_piece) - 1).empty()) {
+                break;
+            }
+            if (last_piece.added.empty()) {
+                last_piece.end--;
+            }
+            else {
+                last_piece.added.pop_back();
+            }
+            if (pieceSize(last_piece) == 0) {
+                pieces.pop_back();
+            }
+        }
+    }
+    else {
+        add_before(pieces.size(), new_lines);
+        position = {pieces.size() + 1, 0};
+    }
+    add_before(pieces.size(), {std::string_view()}); //Every line is written with a newline
+
+    return position.piece < pieces.size() ? position : LangPosition{pieces.size(), 0};
+}
+
+//Finds where one job's definitions go in a Bedrock file and adds them to its pieces
+int insertDefinitions(LangFile &lang_file,const std::string &bedrock_language,const PortJob &job,const std::vector<std::string> &definition,const RunOptions &options,std::ostream &err) {
+
+    std::vector<LangPiece> &pieces = lang_file.pieces;
+
+    //Find correct insertion location in lang file
+    std::string clean_identifier = job.base_bedrock_identifier;
+    std::string alphabetical_identifier;
+    if (!job.sort_override_enabled) {
+        if (job.expansion_type == 'p') { //Remove wildcard part of string
+            clean_identifier = job.base_bedrock_identifier.substr(0, job.base_bedrock_identifier.find('*'));
+        }
+        else if (job.expansion_type != 's') { //Remove VAR part of string
+            clean_identifier = job.base_bedrock_identifier.substr(0, job.base_bedrock_identifier.find("VAR"));
+        }
+        size_t first_period = clean_identifier.find('.');
+        if (first_period != std::string::npos) {
+            alphabetical_identifier = clean_identifier.substr(0,first_period);
+        }
+        else {
+            alphabetical_identifier = clean_identifier;
+        }
+    }
+    else {
+        alphabetical_identifier = job.sort_override;
+    }
+
+    //Add new lines
+    std::vector<std::pair<std::string_view, std::string_view>> new_lines; //Bedrock identifier and line
+    for (size_t k = 0; k < definition.size(); k++) {
+        if (definition.at(k) != "NULL") {
+            std::string &new_line = lang_file.added_lines.emplace_back(job.bedrock_identifier.at(k) + "=" + definition.at(k));
+            if (bedrock_language != "en_US") {
+                new_line += "\t#";
+            }
+            new_lines.emplace_back(job.bedrock_identifier.at(k), new_line);
+        }
+    }
+
+    //Check for duplicate definitions, in the original file and from earlier jobs
+    if (options.on_conflict == "duplicate") {
+        std::unordered_set<std::string_view> job_keys(job.bedrock_identifier.begin(), job.bedrock_identifier.end());
+        for (const auto & [key, line_number] : lang_file.existing_definitions) {
+            if (job_keys.count(key) != 0) {
+                err << "Duplicate definition found in " << bedrock_language << " on line " << line_number << "." << std::endl;
+            }
+        }
+        for (const auto & j : job.bedrock_identifier) {
+            if (lang_file.added_keys.count(j) != 0) {
+                err << "Duplicate definition of " << j << " found in " << bedrock_language << " from an earlier job." << std::endl;
+            }
+        }
+    }
+    else {
+        int conflict_result = resolveConflicts(lang_file, bedrock_language, options, new_lines, err);
+        if (conflict_result != 0) {
+            return conflict_result;
+        }
+    }
+    for (const auto & new_line : new_lines) {
+        lang_file.added_keys.insert(new_line.first);
+    }
+
+    //Lines placed together, with the identifier they are placed by
+    //Block placement puts every line before the first line not less than the first identifier
+    std::vector<std::pair<std::string_view, std::vector<std::string_view>>> groups;
+    if (options.placement == "key") {
+        std::stable_sort(new_lines.begin(), new_lines.end(), [](const auto &a, const auto &b) {
+            return a.first < b.first;
+        });
+        for (const auto & [identifier, line] : new_lines) {
+            groups.emplace_back(identifier, std::vector<std::string_view>{line});
+        }
+    }
+    else {
+        groups.emplace_back(job.bedrock_identifier.at(0), std::vector<std::string_view>());
+        for (const auto & new_line : new_lines) {
+            groups.back().second.push_back(new_line.second);
+        }
+    }
+
+    //Find similar structure to base identifier
+    LangPosition similar_line;
+    if (!alphabetical_identifier.empty()) {
+        similar_line = findLine(lang_file, similar_line, [&](size_t start, size_t end) {
+            return findPrefixLine(lang_file, alphabetical_identifier, start, end);
+        }, [&](std::string_view line) {
+            return line.substr(0, alphabetical_identifier.size()) == alphabetical_identifier;
+        });
+    }
+
+    //Start alphabetical search through current location; sorted groups continue from where the last one stopped
+    //Nothing is placed when every line replaced or kept an existing definition
+    LangPosition search_start = similar_line;
+    for (size_t g = 0; g < groups.size() && !new_lines.empty(); g++) {
+        std::string_view identifier = groups.at(g).first;
+
+        //An empty alphabetical identifier matches before any line is read, where sort override stops at once
+        LangPosition insertion_point = search_start;
+        bool insert_end = false;
+        if (!alphabetical_identifier.empty() || (!identifier.empty() && !job.sort_override_enabled)) {
+            if (insertion_point.piece < pieces.size()) {
+                insertion_point = findLine(lang_file, insertion_point, [&](size_t start, size_t end) {
+                    return findStopLine(lang_file, identifier, job.sort_override_enabled, start, end);
+                }, [&](std::string_view line) { //In sort override, an empty line stops alpha search
+                    return !(line < identifier) || (job.sort_override_enabled && line.empty());
+                });
+            }
+            //Stopping on the final line still inserts at the end
+            insert_end = insertion_point.piece + 1 >= pieces.size() && (insertion_point.piece == pieces.size() || insertion_point.offset + 1 == pieceSize(pieces.back()));
+        }
+
+        //Sometimes, no similar definition is found; every remaining line then goes at the end together
+        if (insert_end) {
+            if (!job.sort_override_enabled) {
+                err << "No similar identifiers found; inserting new lines at end of file." << std::endl;
+            }
+            else {
+                err << "No existing identifiers found matching sort override \"" << job.sort_override << "\"; inserting new lines at end of file." << std::endl;
+            }
+            for (size_t r = g + 1; r < groups.size(); r++) {
+                groups.at(g).second.insert(groups.at(g).second.end(), groups.at(r).second.begin(), groups.at(r).second.end());
+            }
+            insertLines(lang_file, insertion_point, groups.at(g).second, true);
+            break;
+        }
+
+        //New lines go before the line that stopped the search; the file is only rebuilt once all jobs are in
+        search_start = insertLines(lang_file, insertion_point, groups.at(g).second, false);
+    }
+    for (size_t k = 0; k < definition.size(); k++) {
+        if (definition.at(k) == "NULL") {
+            err << "Skipped missing definition for " << job.java_identifier.at(k) << " -> " << job.bedrock_identifier.at(k) << " (Java -> Bedrock)." << std::endl;
+        }
+    }
+    return 0;
+}
+
+//Handles new lines whose keys are already defined, in the original file or by an earlier job, as --on-conflict says
+//Replaced and kept keys are taken out of new_lines; replaced lines keep their place in the file
+int resolveConflicts(LangFile &lang_file,const std::string &bedrock_language,const RunOptions &options,std::vector<std::pair<std::string_view, std::string_view>> &new_lines,std::ostream &err) {
+
+    //The first new line for each key
+    std::unordered_map<std::string_view, std::string_view> key_lines;
+    for (const auto & [key, line] : new_lines) {
+        key_lines.emplace(key, line);
+    }
+
+    //Original lines, found while the file was split
+    std::unordered_set<std::string_view> resolved_keys;
+    bool lines_replaced = false;
+    for (const auto & [key, line_number] : lang_file.existing_definitions) {
+        auto key_line = key_lines.find(key);
+        if (key_line == key_lines.end()) {
+            continue;
+        }
+        if (options.on_conflict == "error") {
+            err << "Aborted; " << key << " is already defined in " << bedrock_language << " on line " << line_number << "." << std::endl;
+            return -13;
+        }
+        if (options.on_conflict == "replace") {
+            lang_file.lines.at(line_number - 1) = key_line->second; //Written in place of the old line's bytes
+            lines_replaced = true;
+            err << "Replaced definition of " << key << " in " << bedrock_language << " on line " << line_number << "." << std::endl;
+        }
+        else {
+            err << "Kept existing definition of " << key << " in " << bedrock_language << " on line " << line_number << "." << std::endl;
+        }
+        resolved_keys.insert(key);
+    }
+
+    //Lines added by earlier jobs, reported in the order of the new lines; a repeated key is handled at its first line
+    std::unordered_map<std::string_view, std::vector<std::string_view *>> added_key_lines; //Built once, at the first replaced key
+    for (const auto & [key, line] : new_lines) {
+        if (lang_file.added_keys.count(key) == 0 || resolved_keys.count(key) != 0) {
+            continue;
+        }
+        if (options.on_conflict == "error") {
+            err << "Aborted; " << key << " was already added to " << bedrock_language << " by an earlier job." << std::endl;
+            return -13;
+        }
+        if (options.on_conflict == "replace") {
+            if (added_key_lines.empty()) {
+                for (auto & piece : lang_file.pieces) {
+                    for (auto & added_line : piece.added) {
+                        added_key_lines[added_line.substr(0, added_line.find('='))].push_back(&added_line);
+                    }
+                }
+            }
+            for (std::string_view *added_line : added_key_lines[key]) {
+                *added_line = line;
+            }
+            err << "Replaced definition of " << key << " in " << bedrock_language << " from an earlier job." << std::endl;
+        }
+        else {
+            err << "Kept definition of " << key << " in " << bedrock_language << " from an earlier job." << std::endl;
+        }
+        resolved_keys.insert(key);
+    }
+
+    //Sorted runs are indexed by whole lines, and a new value can reorder two lines with the same key
+    if (lines_replaced) {
+        indexLangFile(lang_file);
+    }
+    new_lines.erase(std::remove_if(new_lines.begin(), new_lines.end(), [&](const auto &new_line) {
+        return resolved_keys.count(new_line.first) != 0;
+    }), new_lines.end());
+    return 0;
+}
+
+//Builds list identifiers using expansion words and stores in identifier_list
+int expandIdentifier(std::string base_identifier,std::vector<std::string> &identifier_list,const std::vector<std::string> &expansion_list) {
+
+    size_t insertion_point = base_identifier.find("VAR");
+    if (insertion_point == std::string::npos) {
+        std::cerr << "Text \"VAR\" not found in input string." << std::endl;
+        return -1;
+    }
+    base_identifier.erase(insertion_point,3);
+
+    std::string current_identifier;
+    for (const auto & i : expansion_list) { //Iterate through full expansion list
+        current_identifier = base_identifier;
+        current_identifier.insert(insertion_point,i); //Insert expansion into string
+        identifier_list.push_back(current_identifier); //Add to vector
+    }
+
+    std::cout << "Created the following identifiers:" << std::endl;
+    for (const auto & i : identifier_list) {
+        std::cout << i << std::endl;
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
+
+//Reads the keys of every string definition in a Java language file, sorted, for selecting them by pattern
+int readJavaKeys(const std::string &java_path,std::vector<std::string> &java_keys) {
+
+    MappedFile java_file;
+    if (!java_file.open(java_path)) {
+        std::cerr << "Failed to open " << java_path << "." << std::endl;
+        return -1;
+    }
+    std::vector<std::pair<std::string, JavaValue>> java_values;
+    if (!collectJavaStrings(java_file.view(), java_values)) {
+        std::cerr << "Failed to parse " << java_path << "." << std::endl;
+        return -2;
+    }
+    java_keys.reserve(java_values.size());
+    for (auto & java_value : java_values) {
+        java_keys.push_back(std::move(java_value.first));
+    }
+
+    return 0;
+}
+
+//Selects the keys matching the job's Java selector, and builds each Bedrock identifier from the template
+//In both, * stands for any text without a period and ** for any text; the template's wildcards take the selector's matches in order
+int expandPattern(PortJob &job,const std::vector<std::string> &java_keys) {
+
+    const std::string &selector = job.base_java_identifier, &bedrock_template = job.base_bedrock_identifier;
+    std::vector<std::string_view> template_text = splitWildcards(bedrock_template);
+    size_t wildcard_count = splitWildcards(selector).size() - 1;
+    if (template_text.size() - 1 != wildcard_count) {
+        std::cerr << "Bedrock template " << bedrock_template << " needs one wildcard for each of the " << wildcard_count << " in " << selector << "." << std::endl;
+        return -5;
+    }
+    std::vector<std::string_view> captures;
+
+    //Every match starts with the text before the first wildcard, so only that range of the sorted keys is checked
+    std::string_view literal_prefix = std::string_view(selector).substr(0, selector.find('*'));
+    for (auto key = std::lower_bound(java_keys.begin(), java_keys.end(), literal_prefix); key != java_keys.end() && key->compare(0, literal_prefix.size(), literal_prefix) == 0; key++) {
+        captures.clear();
+        if (!matchSelector(selector, *key, captures)) {
+            continue;
+        }
+        std::string bedrock_identifier(template_text.at(0));
+        for (size_t c = 0; c < captures.size(); c++) {
+            bedrock_identifier += captures.at(c);
+            bedrock_identifier += template_text.at(c + 1);
+        }
+        job.java_identifier.push_back(*key);
+        job.bedrock_identifier.push_back(bedrock_identifier);
+    }
+    if (job.java_identifier.empty()) {
+        std::cerr << "No keys in lang_java/en_us.json match " << selector << "." << std::endl;
+        return -4;
+    }
+
+    std::cout << "Created the following identifiers:" << std::endl;
+    for (size_t i = 0; i < job.java_identifier.size(); i++) {
+        std::cout << job.java_identifier.at(i) << " -> " << job.bedrock_identifier.at(i) << std::endl;
+    }
+    std::cout << std::endl;
+
+    return 0;
+}
+
+//Splits a selector or template into the text around its * and ** wildcards
+std::vector<std::string_view> splitWildcards(std::string_view pattern) {
+
+    std::vector<std::string_view> text;
+    size_t start = 0, wildcard;
+    while ((wildcard = pattern.find('*', start)) != std::string_view::npos) {
+        text.push_back(pattern.substr(start, wildcard - start));
+        start = pattern.compare(wildcard, 2, "**") == 0 ? wildcard + 2 : wildcard + 1;
+    }
+    text.push_back(pattern.substr(start));
+    return text;
+}
+
+//Matches key against a selector, adding the text each wildcard matched to captures
+//Wildcards take the longest text that still lets the rest of the selector match
+bool matchSelector(std::string_view selector,std::string_view key,std::vector<std::string_view> &captures) {
+
+    size_t wildcard = selector.find('*');
+    if (key.substr(0, wildcard) != selector.substr(0, wildcard)) {
+        return false;
+    }
+    if (wildcard == std::string_view::npos) {
+        return key.size() == selector.size();
+    }
+    key.remove_prefix(wildcard);
+    bool any_text = selector.compare(wildcard, 2, "**") == 0;
+    std::string_view rest = selector.substr(wildcard + (any_text ? 2 : 1));
+    size_t longest = any_text ? key.size() : std::min(key.find('.'), key.size());
+    for (size_t length = longest + 1; length-- > 0;) {
+        captures.push_back(key.substr(0, length));
+        if (matchSelector(rest, key.substr(length), captures)) {
+            return true;
+        }
+        captures.pop_back();
+    }
+    return false;
+}
+
+//Reads config file (in two-column Java/Bedrock format) into provided vectors
+int readConfigFile(const std::string& input_filename,std::vector<std::string> &java_vector,std::vector<std::string> &bedrock_vector) {
+
+    //Open config file
+    std::ifstream fin(input_filename);
+    if (fin.fail()) {
+        std::cerr << "Failed to open " << input_filename << "." << std::endl;
+        return -1;
+    }
+    std::cout << "Opened " << input_filename << "..." << std::endl;
+
+    std::string input;
+    int cycle = 0; //For alternating Bedrock and Java
+    while (fin >> input) { //Stops at the end of the words, so a trailing newline adds nothing
+        if (cycle % 2 == 0) {
+            java_vector.push_back(input);
+        }
+        else {
+            bedrock_vector.push_back(input); //Push every other word to Bedrock
+        }
+        cycle++;
+    }
+    fin.close();
+    std::cout << "Closed " << input_filename << "..." << std::endl << std::endl;
+
+    //Error checker
+    if (java_vector.size() != bedrock_vector.size() || java_vector.empty()) {
+        std::cerr << "Input file " << input_filename << " does not have an equal number of Java and Bedrock definitions, or file was empty." << std::endl;
+        return -2;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,133 @@
+#ifndef TRANSLATION_PORTER_PORTER_H
+#define TRANSLATION_PORTER_PORTER_H
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "java_cache.h"
+#include "platform.h"
+#include "port_manifest.h"
+#include "profiler.h"
+
+//One port request, read from the command line or from one line of a batch job file
+struct PortJob {
+    char expansion_type = 's';
+    std::string base_java_identifier, base_bedrock_identifier; //Used to construct real identifiers
+    std::string prefix, suffix, sort_override;
+    bool sort_override_enabled = false;
+    std::vector<std::string> java_identifier, bedrock_identifier; //Real identifiers after expansion
+};
+
+//Run of non-empty lines in a Bedrock file; sorted blocks are searched by binary search
+struct LangBlock {
+    size_t begin = 0, end = 0; //Line range; end is the blank line after the block, or the end of the file
+    bool sorted = true;
+};
+
+//Part of the output of a Bedrock file; a range of the original lines, or lines added by jobs
+struct LangPiece {
+    size_t begin = 0, end = 0; //Range of the original lines when nothing is added
+    std::vector<std::string_view> added;
+};
+
+//Line in the output of a Bedrock file, as an offset into one of its pieces
+struct LangPosition {
+    size_t piece = 0, offset = 0;
+};
+
+//Lines of a Bedrock file; existing lines point into the mapped file and added lines are owned here
+struct LangFile {
+    MappedFile mapping;
+    std::vector<std::string_view> lines; //Original lines; only --on-conflict replace changes them, in place
+    std::vector<LangPiece> pieces; //Output in order; inserting splits pieces instead of copying lines
+    std::deque<std::string> added_lines; //Deque keeps added lines in place as more are added
+    std::vector<LangBlock> blocks; //Index of the original lines
+    std::string line_ending = "\n";
+    std::vector<std::pair<std::string_view, size_t>> existing_definitions; //Requested keys already in the file, with line numbers
+    std::unordered_set<std::string_view> added_keys; //Keys added by earlier jobs
+};
+
+//One Java definition; text points into the mapped Java file, the cache, or JavaValues::parsed_values
+struct JavaValue {
+    std::string_view text;
+    bool escaped = false; //text is still JSON-escaped, and is unescaped while the definition is built
+};
+
+//Java definitions of one language, together with the storage their text points into
+struct JavaValues {
+    MappedFile mapping;
+    JavaCache cache;
+    std::deque<std::string> parsed_values; //Values the sax and dom readers copied out; deque keeps them in place
+    std::unordered_map<std::string, JavaValue> values;
+    uint64_t bytes_read = 0; //Size of the file the values were read from: the JSON, or the cache when it was valid
+};
+
+//Run-wide settings given as --options
+struct RunOptions {
+    int thread_count = 1; //Languages ported at once
+    std::string java_reader = "raw"; //raw keeps requested values in the mapped file, sax copies them out, dom parses the whole file
+    std::string placement = "block"; //block inserts a job's lines together, key places each line by its own identifier
+    std::string on_conflict = "duplicate"; //What to do with keys already defined: duplicate, replace, skip or error
+    bool sync_at_end = false; //Flush written files to disk once the run ends
+    bool pipeline = false; //Prefetch, merge and write different languages at the same time
+    size_t pipeline_depth = 2; //Languages waiting between two pipeline stages
+    bool use_cache = false; //Look up Java definitions in compiled .cache files
+    bool incremental = false; //Skip languages that .cache/manifest.txt shows are unchanged since they were last ported
+    bool profile = false; //Record time, bytes and memory of each phase
+    std::string profile_path; //Also write the profile here as JSON
+};
+
+//Languages and jobs
+int runLanguages(size_t language_count,int thread_count,const std::vector<uint64_t> &language_bytes,Profiler *profiler,const std::function<int(size_t,std::ostream&,std::ostream&)> &task);
+uint64_t languageBytes(const std::string &java_language,const std::string &bedrock_language,const RunOptions &options);
+int portLanguage(const std::string &java_language,const std::string &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,PortManifest *manifest,std::ostream &out,std::ostream &err);
+int prepareLanguage(const std::string &java_language,const std::string &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,LangFile &lang_file,std::ostream &out,std::ostream &err);
+int commitLanguage(const std::string &java_language,const std::string &bedrock_language,LangFile &lang_file,Profiler *profiler,std::ostream &out,std::ostream &err);
+void prefetchLanguage(const std::string &java_language,const std::string &bedrock_language,const RunOptions &options,Profiler *profiler);
+int runPipeline(const std::vector<std::string> &java_language,const std::vector<std::string> &bedrock_language,const std::vector<PortJob> &jobs,const RunOptions &options,Profiler *profiler,PortManifest *manifest);
+void reportUnchanged(const std::string &java_language,const std::string &bedrock_language,std::ostream &out);
+uint64_t hashJobs(const std::vector<PortJob> &jobs,const RunOptions &options);
+int parseJob(const std::vector<std::string> &arguments,PortJob &job);
+int expandJob(PortJob &job,std::vector<std::string> &en_us_keys);
+int readJavaKeys(const std::string &java_path,std::vector<std::string> &java_keys);
+int expandPattern(PortJob &job,const std::vector<std::string> &java_keys);
+std::vector<std::string_view> splitWildcards(std::string_view pattern);
+bool matchSelector(std::string_view selector,std::string_view key,std::vector<std::string_view> &captures);
+int readJobFile(const std::string& input_filename,std::vector<PortJob> &jobs);
+int readReleaseDiff(const std::string &old_directory,const std::string &key_map_file,PortJob &job);
+int diffJavaFiles(const std::string &old_path,const std::string &new_path,std::vector<std::string> &changed_keys,std::ostream &out,std::ostream &err);
+bool collectJavaStrings(std::string_view text,std::vector<std::pair<std::string, JavaValue>> &values);
+int deriveKeyMap(const std::string &java_path,const std::string &bedrock_path,const std::string &map_path);
+int readConfigFile(const std::string& input_filename,std::vector<std::string> &java_vector,std::vector<std::string> &bedrock_vector);
+int expandIdentifier(std::string base_identifier,std::vector<std::string> &identifier_list,const std::vector<std::string> &expansion_list);
+
+//Java definitions
+int readJavaDefinitions(const std::string &java_language,const std::vector<PortJob> &jobs,const RunOptions &options,std::vector<std::vector<std::string>> &definitions,uint64_t &bytes_read,std::ostream &out,std::ostream &err);
+int loadJavaValues(const std::string &java_language,const std::unordered_set<std::string> &wanted_identifiers,const RunOptions &options,JavaValues &java_values,std::ostream &out,std::ostream &err);
+int readCachedJavaValues(const std::string &java_language,const std::unordered_set<std::string> &wanted_identifiers,JavaValues &java_values,std::ostream &out,std::ostream &err);
+void keepParsedValue(JavaValues &java_values,const std::string &identifier,std::string value);
+int buildDefinitions(const std::string &java_language,const std::vector<PortJob> &jobs,const JavaValues &java_values,std::vector<std::vector<std::string>> &definitions,std::ostream &out,std::ostream &err);
+
+//Bedrock definitions
+int mergeBedrockDefinitions(const std::string &bedrock_language,const std::vector<PortJob> &jobs,const std::vector<std::vector<std::string>> &definitions,const RunOptions &options,LangFile &lang_file,std::ostream &out,std::ostream &err);
+int readLangFile(const std::string &bedrock_language,const std::vector<PortJob> &jobs,LangFile &lang_file,std::ostream &out,std::ostream &err);
+int insertDefinitions(LangFile &lang_file,const std::string &bedrock_language,const PortJob &job,const std::vector<std::string> &definition,const RunOptions &options,std::ostream &err);
+int resolveConflicts(LangFile &lang_file,const std::string &bedrock_language,const RunOptions &options,std::vector<std::pair<std::string_view, std::string_view>> &new_lines,std::ostream &err);
+void indexLangFile(LangFile &lang_file);
+size_t findPrefixLine(const LangFile &lang_file,std::string_view prefix,size_t start,size_t end);
+size_t findStopLine(const LangFile &lang_file,std::string_view identifier,bool stop_at_blank,size_t start,size_t end);
+size_t pieceSize(const LangPiece &piece);
+std::string_view pieceLine(const LangFile &lang_file,const LangPiece &piece,size_t offset);
+LangPosition findLine(const LangFile &lang_file,LangPosition start,const std::function<size_t(size_t,size_t)> &find_original,const std::function<bool(std::string_view)> &matches);
+LangPosition insertLines(LangFile &lang_file,LangPosition position,const std::vector<std::string_view> &new_lines,bool insert_end);
+int commitLangFile(const std::string &bedrock_language,LangFile &lang_file,std::ostream &out,std::ostream &err);
+std::vector<std::string_view> buildOutputRanges(const LangFile &lang_file);
+
+#endif
@@ -0,0 +1,154 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include "json.hpp"
+#include "platform.h"
+
+Profiler::Phase::Phase(Profiler *profiler,std::string language,std::string phase) : profiler(profiler), start(std::chrono::steady_clock::now()) {
+    if (profiler != nullptr) {
+        record.language = std::move(language);
+        record.phase = std::move(phase);
+    }
+}
+
+Profiler::Phase::~Phase() {
+    finish();
+}
+
+void Profiler::Phase::finish() {
+    if (profiler != nullptr) {
+        record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        record.process_peak_memory = peakMemoryBytes();
+        profiler->record(std::move(record));
+        profiler = nullptr;
+    }
+}
+
+void Profiler::record(PhaseRecord phase_record) {
+    std::lock_guard<std::mutex> lock(records_mutex);
+    records.push_back(std::move(phase_record));
+}
+
+void Profiler::recordWorker(WorkerRecord worker_record) {
+    std::lock_guard<std::mutex> lock(records_mutex);
+    workers.push_back(worker_record);
+}
+
+void Profiler::printSummary(std::ostream &out) const {
+
+    std::lock_guard<std::mutex> lock(records_mutex);
+    double wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+    const double megabyte = 1000000.0;
+
+    //Totals per phase, in the order phases first ran
+    std::vector<std::string> phase_order;
+    std::map<std::string, PhaseRecord> phase_totals;
+    std::map<std::string, int> phase_calls;
+    size_t peak_memory = 0;
+    for (const auto & r : records) {
+        if (phase_totals.count(r.phase) == 0) {
+            phase_order.push_back(r.phase);
+        }
+        PhaseRecord &total = phase_totals[r.phase];
+        total.seconds += r.seconds;
+        total.bytes_read += r.bytes_read;
+        total.bytes_written += r.bytes_written;
+        total.process_peak_memory = std::max(total.process_peak_memory, r.process_peak_memory);
+        phase_calls[r.phase]++;
+        peak_memory = std::max(peak_memory, r.process_peak_memory);
+    }
+
+    out << std::fixed << std::setprecision(2);
+    out << "Profile: " << wall_seconds * 1000 << " ms wall, " << peak_memory / megabyte << " MB peak memory" << std::endl;
+    out << std::left << std::setw(16) << "phase" << std::right << std::setw(8) << "calls" << std::setw(12) << "total ms"
+        << std::setw(12) << "read MB" << std::setw(12) << "written MB" << std::setw(12) << "MB/s" << std::setw(18) << "process peak MB" << std::endl;
+    for (const auto & phase : phase_order) {
+        const PhaseRecord &total = phase_totals.at(phase);
+        double throughput = total.seconds > 0 ? (total.bytes_read + total.bytes_written) / megabyte / total.seconds : 0;
+        out << std::left << std::setw(16) << phase << std::right << std::setw(8) << phase_calls.at(phase) << std::setw(12) << total.seconds * 1000
+            << std::setw(12) << total.bytes_read / megabyte << std::setw(12) << total.bytes_written / megabyte
+            << std::setw(12) << throughput << std::setw(18) << total.process_peak_memory / megabyte << std::endl;
+    }
+
+    //One row per language, one column per language phase
+    std::vector<std::string> language_order, language_phases;
+    std::map<std::string, std::map<std::string, double>> language_seconds;
+    std::map<std::string, PhaseRecord> language_totals;
+    for (const auto & r : records) {
+        if (r.language.empty()) {
+            continue;
+        }
+        if (language_totals.count(r.language) == 0) {
+            language_order.push_back(r.language);
+        }
+        if (std::find(language_phases.begin(), language_phases.end(), r.phase) == language_phases.end()) {
+            language_phases.push_back(r.phase);
+        }
+        language_seconds[r.language][r.phase] += r.seconds;
+        PhaseRecord &total = language_totals[r.language];
+        total.bytes_read += r.bytes_read;
+        total.bytes_written += r.bytes_written;
+    }
+    if (!language_order.empty()) {
+        out << std::endl << std::left << std::setw(16) << "language" << std::right;
+        for (const auto & phase : language_phases) {
+            out << std::setw(std::max<int>(16, static_cast<int>(phase.size()) + 4)) << phase + " ms";
+        }
+        out << std::setw(12) << "read MB" << std::setw(12) << "written MB" << std::endl;
+        for (const auto & language : language_order) {
+            out << std::left << std::setw(16) << language << std::right;
+            for (const auto & phase : language_phases) {
+                out << std::setw(std::max<int>(16, static_cast<int>(phase.size()) + 4)) << language_seconds[language][phase] * 1000;
+            }
+            out << std::setw(12) << language_totals.at(language).bytes_read / megabyte << std::setw(12) << language_totals.at(language).bytes_written / megabyte << std::endl;
+        }
+    }
+
+    //One row per worker; idle time is time not spent running languages before the last worker finished
+    if (!workers.empty()) {
+        std::vector<WorkerRecord> sorted_workers = workers;
+        std::sort(sorted_workers.begin(), sorted_workers.end(), [](const WorkerRecord &a, const WorkerRecord &b) {
+            return a.worker < b.worker;
+        });
+        double last_finish = 0;
+        for (const auto & w : sorted_workers) {
+            last_finish = std::max(last_finish, w.seconds);
+        }
+        out << std::endl << std::left << std::setw(16) << "worker" << std::right << std::setw(12) << "languages" << std::setw(12) << "steals"
+            << std::setw(12) << "MB" << std::setw(12) << "busy ms" << std::setw(12) << "idle ms" << std::endl;
+        for (const auto & w : sorted_workers) {
+            out << std::left << std::setw(16) << w.worker << std::right << std::setw(12) << w.languages << std::setw(12) << w.steals
+                << std::setw(12) << w.bytes / megabyte << std::setw(12) << w.busy_seconds * 1000 << std::setw(12) << (last_finish - w.busy_seconds) * 1000 << std::endl;
+        }
+    }
+}
+
+bool Profiler::writeJson(const std::string &path) const {
+
+    std::lock_guard<std::mutex> lock(records_mutex);
+    nlohmann::json report;
+    report["wall_seconds"] = std::chrono::duration<double>(std::chrono::steady_clock::now() - run_start).count();
+    report["phases"] = nlohmann::json::array();
+    size_t peak_memory = 0;
+    for (const auto & r : records) {
+        report["phases"].push_back({{"language", r.language}, {"phase", r.phase}, {"seconds", r.seconds},
+                                    {"bytes_read", r.bytes_read}, {"bytes_written", r.bytes_written}, {"process_peak_memory_bytes", r.process_peak_memory}});
+        peak_memory = std::max(peak_memory, r.process_peak_memory);
+    }
+    report["peak_memory_bytes"] = peak_memory;
+    report["workers"] = nlohmann::json::array();
+    for (const auto & w : workers) {
+        report["workers"].push_back({{"worker", w.worker}, {"languages", w.languages}, {"steals", w.steals}, {"bytes", w.bytes},
+                                     {"busy_seconds", w.busy_seconds}, {"seconds", w.seconds}});
+    }
+
+    std::ofstream fout(path);
+    if (fout.fail()) {
+        return false;
+    }
+    fout << report.dump(2) << std::endl;
+    return !fout.fail();
+}
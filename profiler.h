@@ -0,0 +1,67 @@
+#ifndef TRANSLATION_PORTER_PROFILER_H
+#define TRANSLATION_PORTER_PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//Wall time, bytes and memory of one phase, for the whole run or for one language
+struct PhaseRecord {
+    std::string language; //Empty for run-wide phases
+    std::string phase;
+    double seconds = 0;
+    uint64_t bytes_read = 0, bytes_written = 0;
+    size_t process_peak_memory = 0; //Peak resident memory of the whole process when the phase ended, not of the phase alone
+};
+
+//Languages and time of one worker thread when languages are ported in parallel
+struct WorkerRecord {
+    size_t worker = 0; //Numbered from 1
+    size_t languages = 0, steals = 0; //Languages run, and how many were taken from another worker's queue
+    uint64_t bytes = 0; //Bytes of the languages run
+    double busy_seconds = 0, seconds = 0; //Time running languages, and time until the worker ran out of work
+};
+
+//Collects phase records from any thread and reports them when the run ends
+class Profiler {
+public:
+    //Times one phase from construction to destruction; does nothing without a profiler
+    class Phase {
+    public:
+        Phase(Profiler *profiler,std::string language,std::string phase);
+        ~Phase();
+        Phase(const Phase &) = delete;
+        Phase &operator=(const Phase &) = delete;
+
+        //Ends the phase early; otherwise it ends when destroyed
+        void finish();
+
+        void addRead(uint64_t bytes) { record.bytes_read += bytes; }
+        void addWritten(uint64_t bytes) { record.bytes_written += bytes; }
+
+    private:
+        Profiler *profiler;
+        PhaseRecord record;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    void record(PhaseRecord phase_record);
+    void recordWorker(WorkerRecord worker_record);
+
+    //Prints phase totals, a row per language, and a row per worker
+    void printSummary(std::ostream &out) const;
+
+    //Writes every record as JSON, for comparing runs
+    bool writeJson(const std::string &path) const;
+
+private:
+    mutable std::mutex records_mutex;
+    std::vector<PhaseRecord> records;
+    std::vector<WorkerRecord> workers;
+    std::chrono::steady_clock::time_point run_start = std::chrono::steady_clock::now();
+};
+
+#endif
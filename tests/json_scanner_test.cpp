@@ -0,0 +1,205 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+#include "json.hpp"
+#include "json_scanner.h"
+#include "porter.h"
+using json = nlohmann::json;
+
+//Checks that scanJsonStrings accepts and rejects exactly what json.hpp does, and finds the same definitions
+//Some valid documents are also read with every --reader and the cache, which must agree with json::parse, as must a truncated cache
+//Usage: ./tp_json_scanner_test [case_count] [seed]
+
+namespace {
+
+const char *const string_parts[] = {"a", "stone", " ", "\\\"", "\\\\", "\\/", "\\n", "\\t", "\\b", "\\f", "\\r", "\\u00a7", "\\u0041", "\\uD83D\\uDE00", "é", "石", "😀", "%s", "\xC3\xA9"};
+const char *const numbers[] = {"0", "-0", "1", "-12", "3.25", "1e5", "1E+2", "2e-3", "1e400", "-1e400", "123456789012345678901234567890"};
+const char *const whitespace[] = {"", "", " ", "\n", "\r\n", "\t"};
+
+std::string randomString(std::mt19937 &random) {
+    std::string text = "\"";
+    for (size_t i = 0; i < random() % 5; i++) {
+        text += string_parts[random() % (sizeof(string_parts) / sizeof(string_parts[0]))];
+    }
+    return text + "\"";
+}
+
+std::string randomValue(std::mt19937 &random,int depth) {
+    switch (depth > 2 ? random() % 3 : random() % 6) {
+        case 0: return randomString(random);
+        case 1: return numbers[random() % (sizeof(numbers) / sizeof(numbers[0]))];
+        case 2: return random() % 3 == 0 ? "true" : random() % 2 == 0 ? "false" : "null";
+        case 3: case 4: {
+            std::string text = "{";
+            for (size_t i = 0, count = random() % 4; i < count; i++) {
+                text += std::string(i == 0 ? "" : ",") + whitespace[random() % 6] + randomString(random) + ":" + whitespace[random() % 6] + randomValue(random, depth + 1);
+            }
+            return text + "}";
+        }
+        default: {
+            std::string text = "[";
+            for (size_t i = 0, count = random() % 4; i < count; i++) {
+                text += std::string(i == 0 ? "" : ",") + whitespace[random() % 6] + randomValue(random, depth + 1);
+            }
+            return text + "]";
+        }
+    }
+}
+
+//Mostly objects of string definitions with repeated keys, like a Java language file
+std::string randomDocument(std::mt19937 &random) {
+    if (random() % 8 == 0) {
+        return randomValue(random, 0);
+    }
+    std::string text = random() % 10 == 0 ? "\xEF\xBB\xBF{" : "{";
+    for (size_t i = 0, count = random() % 6; i < count; i++) {
+        std::string key = random() % 2 == 0 ? "\"k" + std::to_string(random() % 4) + "\"" : randomString(random);
+        std::string value = random() % 4 == 0 ? randomValue(random, 1) : randomString(random);
+        text += std::string(i == 0 ? "" : ",") + whitespace[random() % 6] + key + whitespace[random() % 6] + ":" + value;
+    }
+    return text + "}" + whitespace[random() % 6];
+}
+
+//Damages a valid document with a few random byte changes
+void mutate(std::mt19937 &random,std::string &text) {
+    static const char bytes[] = "{}[]\":,\\u0aeE+-.1 \n\x01\x7F\x80\xBF\xC0\xC2\xE0\xED\xF0\xF4\xF5\xFF";
+    for (size_t m = 0, count = 1 + random() % 3; m < count; m++) {
+        size_t position = text.empty() ? 0 : random() % (text.size() + 1);
+        char byte = bytes[random() % (sizeof(bytes) - 1)];
+        switch (random() % 3) {
+            case 0: text.insert(position, 1, byte); break;
+            case 1: if (position < text.size()) text.erase(position, 1); break;
+            default: if (position < text.size()) text.at(position) = byte; break;
+        }
+    }
+}
+
+//Reads text as lang_java/xx_xx.json with each reader and compares the definitions of wanted with parsed_strings
+bool sameInEveryReader(const std::string &text,const std::unordered_set<std::string> &wanted,const std::map<std::string, std::string> &parsed_strings) {
+    std::ofstream("lang_java/xx_xx.json", std::ios::binary) << text;
+    std::remove(".cache/xx_xx.tpbin"); //The file is rewritten faster than its write time changes
+    std::ostream discard(nullptr);
+    for (const char *reader : {"raw", "sax", "dom", "cache"}) {
+        RunOptions options;
+        options.java_reader = reader;
+        options.use_cache = std::string(reader) == "cache";
+        JavaValues java_values;
+        if (loadJavaValues("xx_xx", wanted, options, java_values, discard, discard) != 0) {
+            std::cerr << "Reader " << reader << " failed." << std::endl;
+            return false;
+        }
+        for (const auto & key : wanted) {
+            auto java_value = java_values.values.find(key);
+            auto parsed_string = parsed_strings.find(key);
+            if ((java_value == java_values.values.end()) != (parsed_string == parsed_strings.end())) {
+                std::cerr << "Reader " << reader << (parsed_string == parsed_strings.end() ? " found " : " missed ") << key << "." << std::endl;
+                return false;
+            }
+            if (java_value != java_values.values.end()) {
+                std::string value;
+                if (java_value->second.escaped) {
+                    appendUnescaped(java_value->second.text, value);
+                }
+                else {
+                    value = java_value->second.text;
+                }
+                if (value != parsed_string->second) {
+                    std::cerr << "Reader " << reader << " read a different value of " << key << "." << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+
+    int case_count = argc > 1 ? std::stoi(argv[1]) : 300000;
+    std::mt19937 random(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1);
+
+    std::error_code error;
+    std::filesystem::path start_directory = std::filesystem::current_path();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("tp_json_scanner_test_" + std::to_string(currentProcessId()));
+    std::filesystem::create_directories(directory / "lang_java", error);
+    if (error) {
+        std::cerr << "Failed to create " << directory.string() << "." << std::endl;
+        return 1;
+    }
+    std::filesystem::current_path(directory);
+
+    int mismatches = 0, accepted_count = 0;
+    for (int i = 0; i < case_count; i++) {
+        std::string text = randomDocument(random);
+        if (random() % 2 == 0) {
+            mutate(random, text);
+        }
+
+        //Every definition, with the last value of a repeated key as json.hpp keeps it
+        std::vector<std::pair<std::string, JavaValue>> values;
+        bool scanned = collectJavaStrings(text, values);
+        bool accepted = json::accept(text);
+
+        bool same_members = true;
+        if (scanned && accepted) {
+            accepted_count++;
+            std::map<std::string, std::string> scanned_strings, parsed_strings;
+            std::unordered_set<std::string> wanted = {"missing"};
+            for (const auto & [key, value] : values) {
+                std::string &unescaped = scanned_strings[key];
+                if (value.escaped) {
+                    appendUnescaped(value.text, unescaped);
+                }
+                else {
+                    unescaped = value.text;
+                }
+            }
+            json document = json::parse(text);
+            if (document.is_object()) {
+                for (const auto & [key, value] : document.items()) {
+                    wanted.insert(key);
+                    if (value.is_string()) {
+                        parsed_strings[key] = value.get<std::string>();
+                    }
+                }
+            }
+            same_members = scanned_strings == parsed_strings && (accepted_count % 20 != 0 || sameInEveryReader(text, wanted, parsed_strings));
+        }
+        if (scanned != accepted || !same_members) {
+            if (++mismatches <= 5) {
+                std::cerr << "Mismatch in case " << i << ": scanner " << (scanned ? "accepted" : "rejected") << ", json.hpp " << (accepted ? "accepted" : "rejected")
+                          << (same_members ? "" : ", different definitions") << std::endl << text << std::endl;
+            }
+        }
+    }
+
+    //A cache cut short after it was built must be rebuilt, not read past its end
+    std::ofstream("lang_java/xx_xx.json", std::ios::binary) << R"({"k0": "Stone", "k1": "Apple"})";
+    std::remove(".cache/xx_xx.tpbin");
+    std::ostream discard(nullptr);
+    RunOptions options;
+    options.use_cache = true;
+    for (int run = 0; run < 2; run++) {
+        JavaValues java_values;
+        if (loadJavaValues("xx_xx", {"k0", "k1"}, options, java_values, discard, discard) != 0 || java_values.values.size() != 2
+            || java_values.values.at("k1").text != "Apple") {
+            std::cerr << "Mismatch reading " << (run == 0 ? "a new" : "a truncated") << " cache." << std::endl;
+            mismatches++;
+        }
+        std::filesystem::resize_file(".cache/xx_xx.tpbin", std::filesystem::file_size(".cache/xx_xx.tpbin", error) - 3, error);
+    }
+
+    std::filesystem::current_path(start_directory);
+    std::filesystem::remove_all(directory, error);
+    std::cout << case_count << " documents (" << accepted_count << " valid), " << mismatches << " mismatches." << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
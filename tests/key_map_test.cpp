@@ -0,0 +1,170 @@
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "porter.h"
+
+//Checks the release diff workflow: a key map written by the a mode from the old release, with added keys written by hand, renames a release diff
+//Also checks how pattern jobs select Java keys and build Bedrock identifiers from them
+//Usage: ./tp_key_map_test
+
+namespace {
+
+int failures = 0;
+
+struct SplitCase {
+    std::string pattern;
+    std::vector<std::string_view> text;
+};
+
+struct MatchCase {
+    std::string selector, key;
+    bool matches;
+    std::vector<std::string_view> captures;
+};
+
+struct PatternCase {
+    std::string selector, bedrock_template;
+    int result;
+    std::vector<std::string> java_identifiers, bedrock_identifiers;
+};
+
+void check(bool passed,const std::string &description) {
+    if (!passed) {
+        std::cerr << "Failed: " << description << std::endl;
+        failures++;
+    }
+}
+
+}
+
+int main() {
+
+    std::error_code error;
+    std::filesystem::path start_directory = std::filesystem::current_path();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("tp_key_map_test_" + std::to_string(currentProcessId()));
+    std::filesystem::create_directories(directory / "lang_java", error);
+    std::filesystem::create_directories(directory / "lang_bedrock", error);
+    std::filesystem::create_directories(directory / "old", error);
+    if (error) {
+        std::cerr << "Failed to create " << directory.string() << "." << std::endl;
+        return 1;
+    }
+    std::filesystem::current_path(directory);
+    std::streambuf *console = std::cout.rdbuf(nullptr); //Progress messages are not checked
+
+    //The Bedrock file matches the old release: one unchanged, one escaped, and one ambiguous definition, and one whose text the new release changed
+    //The new release also adds two definitions, which Bedrock does not have yet
+    std::ofstream("old/en_us.json") << R"({"block.minecraft.stone": "Stone", "item.minecraft.apple": "Old Apple", "item.minecraft.stick": "Stick \"Wood\"", "item.minecraft.bone": "Bone"})";
+    std::ofstream("lang_java/en_us.json") << R"({"block.minecraft.stone": "Stone", "item.minecraft.apple": "Apple", "item.minecraft.gold_ingot": "Gold Ingot",
+        "block.minecraft.new_thing": "New Thing", "item.minecraft.stick": "Stick \"Wood\"", "item.minecraft.bone": "Bone"})";
+    std::ofstream("lang_bedrock/en_US.lang") << "tile.stone.name=Stone\nitem.apple.name=Old Apple\n"
+                                                "item.stick.name=Stick \"Wood\"\t#\nitem.bone.name=Bone\nitem.bone_alias.name=Bone\n";
+
+    //Matched against the new release, the changed definition is lost
+    check(deriveKeyMap("lang_java/en_us.json", "lang_bedrock/en_US.lang", "new_map.txt") == 0, "a writes new_map.txt");
+    std::vector<std::string> java_keys, bedrock_keys;
+    check(readConfigFile("new_map.txt", java_keys, bedrock_keys) == 0, "new_map.txt is read back by readConfigFile");
+    check(java_keys == std::vector<std::string>{"block.minecraft.stone", "item.minecraft.stick"}, "the new release only matches unchanged definitions");
+
+    //Matched against the old release, every unambiguous definition Bedrock has is found
+    check(deriveKeyMap("old/en_us.json", "lang_bedrock/en_US.lang", "map.txt") == 0, "a writes map.txt");
+    java_keys.clear();
+    bedrock_keys.clear();
+    check(readConfigFile("map.txt", java_keys, bedrock_keys) == 0, "map.txt is read back by readConfigFile");
+    check(java_keys == std::vector<std::string>{"block.minecraft.stone", "item.minecraft.apple", "item.minecraft.stick"}, "map.txt holds every unambiguous Java identifier, sorted");
+    check(bedrock_keys == std::vector<std::string>{"tile.stone.name", "item.apple.name", "item.stick.name"}, "map.txt pairs each with its Bedrock identifier");
+
+    //Added definitions are written by hand below the pairs a found
+    std::ifstream map_file("map.txt", std::ios::binary);
+    std::string map_text((std::istreambuf_iterator<char>(map_file)), std::istreambuf_iterator<char>());
+    check(!map_text.empty() && map_text.back() == '\n', "map.txt ends with a newline");
+    std::ofstream("map.txt", std::ios::app) << "item.minecraft.gold_ingot item.gold_ingot.name\nblock.minecraft.new_thing tile.new_thing.name\n";
+
+    //The changed and added definitions are renamed through the map
+    PortJob job;
+    check(readReleaseDiff("old", "map.txt", job) == 0, "d reads map.txt");
+    check(job.java_identifier == std::vector<std::string>{"block.minecraft.new_thing", "item.minecraft.apple", "item.minecraft.gold_ingot"}, "d ports the added and changed definitions");
+    check(job.bedrock_identifier == std::vector<std::string>{"tile.new_thing.name", "item.apple.name", "item.gold_ingot.name"}, "d uses the Bedrock identifiers from map.txt");
+
+    //Hand-written config files may end with a newline or not, but must not be empty
+    std::ofstream("newline.txt") << "en_us en_US\nde_de de_DE\n";
+    std::vector<std::string> java_languages, bedrock_languages;
+    check(readConfigFile("newline.txt", java_languages, bedrock_languages) == 0 && java_languages.size() == 2, "a trailing newline adds no entry");
+    std::ofstream("empty.txt") << "\n";
+    java_languages.clear();
+    bedrock_languages.clear();
+    std::streambuf *errors = std::cerr.rdbuf(nullptr);
+    int empty_result = readConfigFile("empty.txt", java_languages, bedrock_languages);
+    std::cerr.rdbuf(errors);
+    check(empty_result != 0, "an empty config file is rejected");
+
+    //Wildcards at the start, the end, next to each other, and more than one per pattern
+    const std::vector<SplitCase> split_cases = {
+        {"block.minecraft.stone", {"block.minecraft.stone"}},
+        {"block.minecraft.*", {"block.minecraft.", ""}},
+        {"*.name", {"", ".name"}},
+        {"block.*.*_wool", {"block.", ".", "_wool"}},
+        {"item.**.name", {"item.", ".name"}},
+        {"**", {"", ""}},
+        {"a***b", {"a", "", "b"}},
+    };
+    for (const auto & c : split_cases) {
+        check(splitWildcards(c.pattern) == c.text, "splitWildcards(" + c.pattern + ")");
+    }
+
+    //* stops at periods and ** does not; each wildcard takes the longest text that lets the rest match
+    const std::vector<MatchCase> match_cases = {
+        {"block.minecraft.stone", "block.minecraft.stone", true, {}},
+        {"block.minecraft.stone", "block.minecraft.stones", false, {}},
+        {"block.minecraft.*", "block.minecraft.stone", true, {"stone"}},
+        {"block.minecraft.*", "block.minecraft.stone.slab", false, {}},
+        {"block.minecraft.**", "block.minecraft.stone.slab", true, {"stone.slab"}},
+        {"block.minecraft.*", "block.minecraft.", true, {""}},
+        {"*.minecraft.stone", "block.minecraft.stone", true, {"block"}},
+        {"*.x", "a.b.x", false, {}},
+        {"**.name", "a.b.name", true, {"a.b"}},
+        {"block.*.*_wool", "block.minecraft.red_wool", true, {"minecraft", "red"}},
+        {"*_*", "a_b_c", true, {"a_b", "c"}},
+        {"item.*", "block.minecraft.stone", false, {}},
+        {"block.*.slab", "block.minecraft.stone", false, {}},
+    };
+    for (const auto & c : match_cases) {
+        std::vector<std::string_view> captures;
+        bool matches = matchSelector(c.selector, c.key, captures);
+        check(matches == c.matches && (!matches || captures == c.captures), "matchSelector(" + c.selector + ", " + c.key + ")");
+    }
+
+    //Java keys are sorted, as readJavaKeys returns them
+    const std::vector<std::string> pattern_keys = {"block.minecraft.blue_wool", "block.minecraft.red_wool", "block.minecraft.stone", "block.minecraft.stone.slab", "item.minecraft.apple"};
+    const std::vector<PatternCase> pattern_cases = {
+        {"block.minecraft.*_wool", "tile.wool.*.name", 0, {"block.minecraft.blue_wool", "block.minecraft.red_wool"}, {"tile.wool.blue.name", "tile.wool.red.name"}},
+        {"*.minecraft.apple", "*.apple.name", 0, {"item.minecraft.apple"}, {"item.apple.name"}},
+        {"block.minecraft.**", "tile.**", 0, {"block.minecraft.blue_wool", "block.minecraft.red_wool", "block.minecraft.stone", "block.minecraft.stone.slab"},
+            {"tile.blue_wool", "tile.red_wool", "tile.stone", "tile.stone.slab"}},
+        {"block.*.stone", "tile.*", 0, {"block.minecraft.stone"}, {"tile.minecraft"}},
+        {"entity.*", "entity.*.name", -4, {}, {}},
+        {"block.*.*", "tile.*", -5, {}, {}},
+    };
+    std::streambuf *pattern_errors = std::cerr.rdbuf(nullptr);
+    for (const auto & c : pattern_cases) {
+        PortJob pattern_job;
+        pattern_job.expansion_type = 'p';
+        pattern_job.base_java_identifier = c.selector;
+        pattern_job.base_bedrock_identifier = c.bedrock_template;
+        int result = expandPattern(pattern_job, pattern_keys);
+        check(result == c.result && pattern_job.java_identifier == c.java_identifiers && pattern_job.bedrock_identifier == c.bedrock_identifiers,
+              "expandPattern(" + c.selector + ", " + c.bedrock_template + ")");
+    }
+    std::cerr.rdbuf(pattern_errors);
+
+    std::cout.rdbuf(console);
+    std::filesystem::current_path(start_directory);
+    std::filesystem::remove_all(directory, error);
+    std::cout << failures << " failed checks." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
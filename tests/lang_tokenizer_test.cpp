@@ -0,0 +1,75 @@
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "lang_tokenizer.h"
+
+//Checks every tokenizer this processor can run against a plain split of random text
+//Usage: ./tp_lang_tokenizer_test [case_count] [seed]
+
+namespace {
+
+//Lines as getline splits them, each keyed up to its first '='
+std::vector<LangToken> referenceTokens(const std::string &text) {
+    std::vector<LangToken> tokens;
+    size_t begin = 0;
+    while (true) {
+        size_t newline = text.find('\n', begin);
+        size_t end = newline == std::string::npos ? text.size() : newline;
+        size_t equals = text.find('=', begin);
+        tokens.push_back({begin, (equals < end ? equals : end) - begin, end - begin});
+        if (newline == std::string::npos) {
+            return tokens;
+        }
+        begin = newline + 1;
+    }
+}
+
+bool sameTokens(const std::vector<LangToken> &a,const std::vector<LangToken> &b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t t = 0; t < a.size(); t++) {
+        if (a.at(t).begin != b.at(t).begin || a.at(t).key_size != b.at(t).key_size || a.at(t).size != b.at(t).size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+
+    int case_count = argc > 1 ? std::stoi(argv[1]) : 20000;
+    std::mt19937 random(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1);
+
+    //Lengths cross the 16 and 32 byte blocks, with runs of newlines and '=' inside and across them
+    static const char bytes[] = "ab=\n\r.\x80\xFF";
+    std::vector<std::string> texts(case_count);
+    for (auto & text : texts) {
+        size_t length = random() % 4 == 0 ? random() % 300 : random() % 70;
+        for (size_t i = 0; i < length; i++) {
+            text += bytes[random() % (sizeof(bytes) - 1)];
+        }
+    }
+
+    int mismatches = 0, tested = 0;
+    std::vector<LangToken> tokens;
+    for (const char *name : {"scalar", "sse2", "avx2"}) {
+        if (!useLangTokenizer(name)) {
+            std::cout << "Skipped " << name << ", which this processor cannot run." << std::endl;
+            continue;
+        }
+        tested++;
+        for (const auto & text : texts) {
+            tokenizeLang(text, tokens);
+            if (!sameTokens(tokens, referenceTokens(text)) && ++mismatches <= 5) {
+                std::cerr << "Mismatch with " << name << " on " << text.size() << " bytes: " << text << std::endl;
+            }
+        }
+    }
+
+    std::cout << case_count << " texts with " << tested << " tokenizers, " << mismatches << " mismatches." << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
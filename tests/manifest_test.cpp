@@ -0,0 +1,105 @@
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "porter.h"
+
+//Checks which --incremental runs are skipped: unchanged and touched files are, and changed jobs, options and damaged manifests port again
+//Usage: ./tp_manifest_test
+
+namespace {
+
+int failures = 0;
+
+void check(bool passed,const std::string &description) {
+    if (!passed) {
+        std::cerr << "Failed: " << description << std::endl;
+        failures++;
+    }
+}
+
+std::string readFile(const std::string &path) {
+    std::ifstream fin(path, std::ios::binary);
+    return std::string((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+}
+
+//One --incremental run of en_us into en_US, as main runs it; true when en_US.lang was left as it was
+bool skipped(const std::vector<PortJob> &jobs,const RunOptions &options,int &result) {
+    std::string before = readFile("lang_bedrock/en_US.lang");
+    std::ostream discard(nullptr);
+    PortManifest manifest(hashJobs(jobs, options));
+    manifest.load(".cache/manifest.txt");
+    result = portLanguage("en_us", "en_US", jobs, options, nullptr, &manifest, discard, discard);
+    if (!manifest.save(".cache/manifest.txt")) {
+        result = -10;
+    }
+    return readFile("lang_bedrock/en_US.lang") == before;
+}
+
+}
+
+int main() {
+
+    std::error_code error;
+    std::filesystem::path start_directory = std::filesystem::current_path();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("tp_manifest_test_" + std::to_string(currentProcessId()));
+    std::filesystem::create_directories(directory / "lang_java", error);
+    std::filesystem::create_directories(directory / "lang_bedrock", error);
+    if (error) {
+        std::cerr << "Failed to create " << directory.string() << "." << std::endl;
+        return 1;
+    }
+    std::filesystem::current_path(directory);
+
+    std::ofstream("lang_java/en_us.json") << R"({"block.minecraft.stone": "Stone", "block.minecraft.dirt": "Dirt"})";
+    std::ofstream("lang_bedrock/en_US.lang") << "tile.grass.name=Grass\ntile.wood.name=Wood\n";
+    std::vector<PortJob> jobs(1);
+    jobs.at(0).expansion_type = 's';
+    jobs.at(0).base_java_identifier = "block.minecraft.stone";
+    jobs.at(0).base_bedrock_identifier = "tile.stone.name";
+    jobs.at(0).java_identifier = {"block.minecraft.stone"};
+    jobs.at(0).bedrock_identifier = {"tile.stone.name"};
+    RunOptions options;
+    options.incremental = true;
+
+    //The first run ports; running it again finds nothing changed
+    int result = 0;
+    check(!skipped(jobs, options, result) && result == 0, "the first run ports");
+    check(skipped(jobs, options, result) && result == 0, "an unchanged run is skipped");
+
+    //A new write time alone, as after a checkout, is still unchanged, and the new time is kept
+    for (const char *path : {"lang_java/en_us.json", "lang_bedrock/en_US.lang"}) {
+        std::filesystem::last_write_time(path, std::filesystem::last_write_time(path, error) + std::chrono::hours(1), error);
+    }
+    check(!error && skipped(jobs, options, result) && result == 0, "touched files with the same contents are skipped");
+    check(skipped(jobs, options, result) && result == 0, "the touched files are still skipped on the next run");
+
+    //Changing a job or an option that decides the output ports again
+    std::vector<PortJob> changed_jobs = jobs;
+    changed_jobs.at(0).java_identifier = {"block.minecraft.dirt"};
+    changed_jobs.at(0).bedrock_identifier = {"tile.dirt.name"};
+    check(!skipped(changed_jobs, options, result) && result == 0, "a changed job ports again");
+    RunOptions changed_options = options;
+    changed_options.placement = "key";
+    check(!skipped(changed_jobs, changed_options, result) && result == 0, "a changed option ports again");
+    check(skipped(changed_jobs, changed_options, result) && result == 0, "the changed run is skipped once recorded");
+
+    //A damaged manifest holds no entries, so the language is ported without an error; each is cut from the manifest of the run before it
+    for (int damage = 0; damage < 4; damage++) {
+        std::string manifest_text = readFile(".cache/manifest.txt");
+        const std::string damaged[] = {"not a manifest\n", manifest_text.substr(0, manifest_text.size() / 2), manifest_text.substr(0, manifest_text.size() - 3), ""};
+        std::ofstream(".cache/manifest.txt", std::ios::binary) << damaged[damage];
+        check(!skipped(changed_jobs, changed_options, result) && result == 0, "damaged manifest " + std::to_string(damage) + " ports again");
+    }
+    std::filesystem::remove(".cache/manifest.txt", error);
+    check(!skipped(changed_jobs, changed_options, result) && result == 0, "a missing manifest ports again");
+
+    std::filesystem::current_path(start_directory);
+    std::filesystem::remove_all(directory, error);
+    std::cout << failures << " failed checks." << std::endl;
+    return failures == 0 ? 0 : 1;
+}
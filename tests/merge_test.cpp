@@ -0,0 +1,277 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "porter.h"
+
+//Checks the block index and piece merge against the original one-job-at-a-time splice, on random .lang files
+//Every case is merged with both --placement choices; key placement splices each new line on its own
+//Keys already defined are first resolved by each --on-conflict choice, line by line
+//Usage: ./tp_merge_test [case_count] [seed]
+
+namespace {
+
+const char *const colors[] = {"black", "blue", "brown", "cyan", "gray", "green", "lightBlue", "silver", "lime", "magenta", "orange", "pink", "purple", "red", "white", "yellow"};
+
+std::vector<std::string> splitLines(const std::string &text) {
+    std::vector<std::string> lines;
+    std::istringstream copyin(text);
+    std::string current_line;
+    while (!copyin.eof()) {
+        getline(copyin, current_line, '\n');
+        lines.push_back(current_line);
+    }
+    return lines;
+}
+
+std::string alphabeticalIdentifier(const PortJob &job) {
+    if (job.sort_override_enabled) {
+        return job.sort_override;
+    }
+    std::string clean_identifier = job.expansion_type != 's' ? job.base_bedrock_identifier.substr(0, job.base_bedrock_identifier.find("VAR")) : job.base_bedrock_identifier;
+    return clean_identifier.substr(0, clean_identifier.find('.'));
+}
+
+//The splice of the original tool for one job: rewrite the whole file around the first line not less than the first identifier
+std::string referenceSplice(const std::string &text,const std::string &bedrock_language,const PortJob &job,const std::vector<std::string> &definition) {
+
+    std::string alphabetical_identifier = alphabeticalIdentifier(job);
+    std::vector<std::string> lines = splitLines(text), pre_insertion_file, post_insertion_file;
+    size_t next = 0;
+    std::string current_line, trimmed_line;
+    while (next < lines.size() && alphabetical_identifier != trimmed_line) {
+        current_line = lines.at(next++);
+        pre_insertion_file.push_back(current_line);
+        trimmed_line = current_line.substr(0, alphabetical_identifier.size());
+    }
+    while (next < lines.size() && current_line < job.bedrock_identifier.at(0) && !(job.sort_override_enabled && current_line.empty())) {
+        current_line = lines.at(next++);
+        pre_insertion_file.push_back(current_line);
+    }
+    bool insert_end = next == lines.size();
+    post_insertion_file.assign(lines.begin() + next, lines.end());
+    while (!post_insertion_file.empty() && post_insertion_file.back().empty()) {
+        post_insertion_file.pop_back();
+    }
+
+    std::string output;
+    for (size_t j = 0; j + 1 < pre_insertion_file.size(); j++) {
+        output += pre_insertion_file.at(j) + "\n";
+    }
+    if (insert_end) {
+        output += pre_insertion_file.back() + "\n";
+    }
+    for (size_t k = 0; k < definition.size(); k++) {
+        if (definition.at(k) != "NULL") {
+            output += job.bedrock_identifier.at(k) + "=" + definition.at(k) + (bedrock_language != "en_US" ? "\t#" : "") + "\n";
+        }
+    }
+    if (!insert_end) {
+        output += pre_insertion_file.back() + "\n";
+        for (const auto & l : post_insertion_file) {
+            output += l + "\n";
+        }
+    }
+    return output;
+}
+
+//Key placement: the splice above for each new line alone, in identifier order, each search going on from the line the last one stopped at
+//Once one line reaches the end of the file, the rest follow it there
+std::string referenceKeySplice(const std::string &text,const std::string &bedrock_language,const PortJob &job,const std::vector<std::string> &definition) {
+
+    std::vector<std::pair<std::string, std::string>> new_lines;
+    for (size_t k = 0; k < definition.size(); k++) {
+        if (definition.at(k) != "NULL") {
+            new_lines.emplace_back(job.bedrock_identifier.at(k), job.bedrock_identifier.at(k) + "=" + definition.at(k) + (bedrock_language != "en_US" ? "\t#" : ""));
+        }
+    }
+    std::stable_sort(new_lines.begin(), new_lines.end(), [](const auto &a, const auto &b) {
+        return a.first < b.first;
+    });
+
+    //current is the line the search stands on; the last line always ends the search
+    std::string alphabetical_identifier = alphabeticalIdentifier(job);
+    std::vector<std::string> lines = splitLines(text);
+    size_t current = 0;
+    while (!alphabetical_identifier.empty() && current + 1 < lines.size() && lines.at(current).substr(0, alphabetical_identifier.size()) != alphabetical_identifier) {
+        current++;
+    }
+    for (size_t n = 0; n < new_lines.size(); n++) {
+        const std::string &identifier = new_lines.at(n).first;
+        while (current + 1 < lines.size() && lines.at(current) < identifier && !(job.sort_override_enabled && lines.at(current).empty())) {
+            current++;
+        }
+        if (current + 1 == lines.size()) {
+            for (size_t r = n; r < new_lines.size(); r++) {
+                lines.push_back(new_lines.at(r).second);
+            }
+            lines.emplace_back();
+            break;
+        }
+        lines.insert(lines.begin() + current++, new_lines.at(n).second);
+        while (lines.size() > current + 1 && lines.back().empty()) {
+            lines.pop_back();
+        }
+        lines.emplace_back();
+    }
+
+    std::string output;
+    for (size_t l = 0; l < lines.size(); l++) {
+        output += (l == 0 ? "" : "\n") + lines.at(l);
+    }
+    return output;
+}
+
+//Handles the job's keys already in text as --on-conflict says; handled definitions become "NULL"
+//Returns false when the merge is aborted
+bool referenceConflicts(std::string &text,const std::string &bedrock_language,const PortJob &job,std::vector<std::string> &definition,const std::string &on_conflict) {
+
+    if (on_conflict == "duplicate") {
+        return true;
+    }
+    std::vector<std::string> lines = splitLines(text);
+    for (size_t k = 0; k < definition.size(); k++) {
+        if (definition.at(k) == "NULL") {
+            continue;
+        }
+        bool defined = false;
+        for (auto & line : lines) {
+            if (line.substr(0, line.find('=')) == job.bedrock_identifier.at(k)) {
+                defined = true;
+                if (on_conflict == "replace") {
+                    line = job.bedrock_identifier.at(k) + "=" + definition.at(k) + (bedrock_language != "en_US" ? "\t#" : "");
+                }
+            }
+        }
+        if (defined && on_conflict == "error") {
+            return false;
+        }
+        if (defined) {
+            definition.at(k) = "NULL";
+        }
+    }
+    text.clear();
+    for (size_t l = 0; l < lines.size(); l++) {
+        text += (l == 0 ? "" : "\n") + lines.at(l);
+    }
+    return true;
+}
+
+template <class T>
+const T &pick(std::mt19937 &random,const std::vector<T> &choices) {
+    return choices.at(random() % choices.size());
+}
+
+std::string randomKey(std::mt19937 &random) {
+    return pick<std::string>(random, {"tile", "item", "entity", "zz", "a", "item.apple"}) + "." + pick<std::string>(random, {"stone", "wool", "apple", "b", "c", "x"}) + pick<std::string>(random, {"", ".name", ".white.name"});
+}
+
+void randomJob(std::mt19937 &random,PortJob &job,std::vector<std::string> &definition) {
+    if (random() % 3 != 0) {
+        job.expansion_type = 's';
+        job.base_bedrock_identifier = pick<std::string>(random, {"tile.stone.name", "item.apple.name", "zz.b", "a", "aaa.x", "tile.x", "tile.wool.white.name", randomKey(random)});
+        job.bedrock_identifier = {job.base_bedrock_identifier};
+    }
+    else {
+        job.expansion_type = 'c';
+        job.base_bedrock_identifier = pick<std::string>(random, {"tile.wool.VAR.name", "item.VAR.x", "zz.VAR"});
+        size_t var = job.base_bedrock_identifier.find("VAR");
+        for (size_t c = 0; c < 1 + random() % 16; c++) {
+            job.bedrock_identifier.push_back(job.base_bedrock_identifier.substr(0, var) + colors[c] + job.base_bedrock_identifier.substr(var + 3));
+        }
+    }
+    if (random() % 2 == 0) {
+        job.sort_override_enabled = true;
+        job.sort_override = pick<std::string>(random, {"item", "tile", "zz", "q"});
+    }
+    for (size_t k = 0; k < job.bedrock_identifier.size(); k++) {
+        job.java_identifier.push_back("java." + job.bedrock_identifier.at(k)); //Only named in messages
+        definition.push_back(random() % 4 == 0 ? "NULL" : pick<std::string>(random, {"Stone", "Apple", "Wool é", "Q \"x\""}));
+    }
+    definition.at(random() % definition.size()) = "Value"; //A job with no definitions at all is aborted before merging
+}
+
+}
+
+int main(int argc, char* argv[]) {
+
+    int case_count = argc > 1 ? std::stoi(argv[1]) : 2000;
+    std::mt19937 random(argc > 2 ? static_cast<unsigned>(std::stoul(argv[2])) : 1);
+
+    std::error_code error;
+    std::filesystem::path start_directory = std::filesystem::current_path();
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / ("tp_merge_test_" + std::to_string(currentProcessId()));
+    std::filesystem::create_directories(directory / "lang_bedrock", error);
+    if (error) {
+        std::cerr << "Failed to create " << directory.string() << "." << std::endl;
+        return 1;
+    }
+    std::filesystem::current_path(directory);
+
+    std::ostream discard(nullptr);
+    int mismatches = 0;
+    for (int i = 0; i < case_count; i++) {
+
+        //Random Bedrock file, sometimes already sorted, with or without trailing newlines
+        std::vector<std::string> lines(random() % 13);
+        for (auto & line : lines) {
+            line = pick<std::string>(random, {randomKey(random) + "=v", "", "## comment"});
+        }
+        if (random() % 2 == 0) {
+            std::sort(lines.begin(), lines.end());
+        }
+        std::string text;
+        for (size_t l = 0; l < lines.size(); l++) {
+            text += (l == 0 ? "" : "\n") + lines.at(l);
+        }
+        text += pick<std::string>(random, {"", "\n", "\n\n"});
+        std::string bedrock_language = random() % 2 == 0 ? "en_US" : "de_DE";
+        std::ofstream(std::string("lang_bedrock/") + bedrock_language + ".lang", std::ios::binary) << text;
+
+        //Several jobs in one merge must match running them one after another, with either placement
+        RunOptions options;
+        options.on_conflict = pick<std::string>(random, {"duplicate", "replace", "skip", "error"});
+        std::vector<PortJob> jobs(1 + random() % 3);
+        std::vector<std::vector<std::string>> definitions(jobs.size());
+        for (size_t j = 0; j < jobs.size(); j++) {
+            randomJob(random, jobs.at(j), definitions.at(j));
+        }
+        for (const char *placement : {"block", "key"}) {
+            options.placement = placement;
+            std::string expected = text;
+            bool aborted = false;
+            for (size_t j = 0; j < jobs.size() && !aborted; j++) {
+                std::vector<std::string> definition = definitions.at(j);
+                if (!referenceConflicts(expected, bedrock_language, jobs.at(j), definition, options.on_conflict)) {
+                    aborted = true;
+                }
+                else if (std::any_of(definition.begin(), definition.end(), [](const std::string &d) { return d != "NULL"; })) { //Nothing moves when every key was handled
+                    expected = options.placement == "key" ? referenceKeySplice(expected, bedrock_language, jobs.at(j), definition) : referenceSplice(expected, bedrock_language, jobs.at(j), definition);
+                }
+            }
+
+            std::string actual;
+            LangFile lang_file;
+            int result = mergeBedrockDefinitions(bedrock_language, jobs, definitions, options, lang_file, discard, discard);
+            for (std::string_view range : buildOutputRanges(lang_file)) {
+                actual += range;
+            }
+            if (aborted ? result != -13 : result != 0 || actual != expected) {
+                if (++mismatches <= 5) {
+                    std::cerr << "Mismatch in case " << i << " (" << bedrock_language << ", " << jobs.size() << " jobs, --placement " << options.placement << ", --on-conflict " << options.on_conflict << ", result " << result << ")" << std::endl
+                              << "input:" << std::endl << text << std::endl << "expected:" << std::endl << expected << std::endl << "actual:" << std::endl << actual << std::endl;
+                }
+            }
+        }
+    }
+
+    std::filesystem::current_path(start_directory);
+    std::filesystem::remove_all(directory, error);
+    std::cout << case_count << " cases in both placements, " << mismatches << " mismatches." << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}